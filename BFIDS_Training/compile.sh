@@ -3,30 +3,56 @@
 echo "--- Compiling BFIDS System for Ubuntu (SSH) ---"
 
 # 1. Compile the Log Trainer (Historical Data)
-echo "[1/3] Compiling Log Trainer..."
-g++ -I include src/train_system.cpp \
+echo "[1/9] Compiling Log Trainer..."
+g++ -I include -pthread src/train_system.cpp \
     src/file_io.cpp \
+    src/log_parser.cpp \
+    src/external_sort.cpp \
+    src/symbol_table.cpp \
+    src/event_table.cpp \
+    src/event_log.cpp \
+    src/parallel_ingest.cpp \
+    src/process_totals.cpp \
     src/linked_list.cpp \
     src/avl_profile.cpp \
+    src/frozen_profile.cpp \
+    src/fingerprint_file.cpp \
     src/sorting_algorithms.cpp \
     src/utils.cpp \
     src/btree_index.cpp \
+    src/disk_btree.cpp \
     -o train_system
 
 # 2. Compile the Biometric Trainer (Live Training)
-echo "[2/3] Compiling Biometric Trainer..."
-g++ -I include src/bio_trainer.cpp \
+echo "[2/9] Compiling Biometric Trainer..."
+g++ -I include -pthread src/bio_trainer.cpp \
     src/avl_profile.cpp \
+    src/frozen_profile.cpp \
+    src/fingerprint_file.cpp \
+    src/fingerprint_store.cpp \
+    src/action_log_writer.cpp \
+    src/file_io.cpp \
+    src/log_parser.cpp \
+    src/external_sort.cpp \
+    src/symbol_table.cpp \
+    src/event_table.cpp \
+    src/sorting_algorithms.cpp \
+    src/event_log.cpp \
+    src/linked_list.cpp \
     src/queue_monitor.cpp \
     src/stack_monitor.cpp \
     src/utils.cpp \
     src/btree_index.cpp \
+    src/disk_btree.cpp \
     -o bio_trainer
 
 # 3. Compile the Biometric Monitor (Live Security)
-echo "[3/3] Compiling Biometric Monitor..."
+echo "[3/9] Compiling Biometric Monitor..."
 g++ -I include src/bio_monitor.cpp \
     src/avl_profile.cpp \
+    src/frozen_profile.cpp \
+    src/fingerprint_file.cpp \
+    src/log_parser.cpp \
     src/Array_handler.cpp \
     src/pointer_utils.cpp \
     src/utils.cpp \
@@ -35,7 +61,77 @@ g++ -I include src/bio_monitor.cpp \
     src/anomaly_heap.cpp \
     src/process_trie.cpp \
     src/btree_index.cpp \
+    src/disk_btree.cpp \
     -o bio_monitor
 
+# 4. Compile the Live Monitor (Manual / Event Log Replay / Log Follow)
+echo "[4/9] Compiling Live Monitor..."
+g++ -I include src/live_monitor.cpp \
+    src/avl_profile.cpp \
+    src/frozen_profile.cpp \
+    src/fingerprint_file.cpp \
+    src/event_log.cpp \
+    src/log_follower.cpp \
+    src/log_parser.cpp \
+    src/linked_list.cpp \
+    src/btree_index.cpp \
+    src/disk_btree.cpp \
+    -o live_monitor
+
+# 5. Compile the Log Converter (Text -> Binary Event Log)
+echo "[5/9] Compiling Log Converter..."
+g++ -I include src/log_convert.cpp \
+    src/log_parser.cpp \
+    src/event_log.cpp \
+    src/linked_list.cpp \
+    -o log_convert
+
+# 6. Compile the Log Query tool (Segmented Log Import / Time Window Lookup / In-memory B+Tree)
+echo "[6/9] Compiling Log Query..."
+g++ -I include src/log_query.cpp \
+    src/segmented_log.cpp \
+    src/event_tree.cpp \
+    src/file_io.cpp \
+    src/log_parser.cpp \
+    src/external_sort.cpp \
+    src/symbol_table.cpp \
+    src/event_table.cpp \
+    src/sorting_algorithms.cpp \
+    src/event_log.cpp \
+    src/linked_list.cpp \
+    src/utils.cpp \
+    -o log_query
+
+# 7. Compile the AVL Profile Benchmark (optimized; insert / lookup / teardown timings, lookup allocation count, concurrent publish + stress)
+echo "[7/9] Compiling AVL Benchmark..."
+g++ -O2 -I include -pthread src/avl_bench.cpp \
+    src/avl_profile.cpp \
+    src/concurrent_profile.cpp \
+    src/frozen_profile.cpp \
+    src/fingerprint_file.cpp \
+    src/log_parser.cpp \
+    src/hash_profiles.cpp \
+    src/graph_transition.cpp \
+    src/btree_index.cpp \
+    src/disk_btree.cpp \
+    -o avl_bench
+
+# 8. Compile the Profile Query tool (Prefix / Range / indexed point lookups over a fingerprint)
+echo "[8/9] Compiling Profile Query..."
+g++ -I include src/profile_query.cpp \
+    src/avl_profile.cpp \
+    src/frozen_profile.cpp \
+    src/fingerprint_file.cpp \
+    src/log_parser.cpp \
+    src/btree_index.cpp \
+    src/disk_btree.cpp \
+    -o profile_query
+
+# 9. Compile the B-Tree Index Benchmark (optimized; fanout sweep over 10M keys)
+echo "[9/9] Compiling B-Tree Benchmark..."
+g++ -O2 -I include src/btree_bench.cpp \
+    src/btree_index.cpp \
+    -o btree_bench
+
 echo "--- Compilation Complete! ---"
 echo "Run ./bio_trainer to train and ./bio_monitor to secure."
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define USER_ACTION_PROFILE_H
 
 #include <string>
+#include "duration_stats.h"
 using namespace std;
 
 /*
@@ -9,24 +10,26 @@ using namespace std;
  * -----------------
  * Represents the statistical fingerprint for a single process.
  * Used in:
- * - Training Phase: store frequency + avgDuration
+ * - Training Phase: store frequency + avgDuration (+ spread, see DurationStats)
  * - Live Detection: compare new events vs stored statistics
  *
  * Fields:
- * processName, frequency, avgDuration
+ * processName, frequency, avgDuration, m2, minDuration, maxDuration, buckets
  */
-struct UserActionProfile {
+struct UserActionProfile : public DurationStats {
     string processName;   // Key used in the AVL tree
-    int frequency;        // How many times process occurred
-    double avgDuration;   // Rolling average duration
 
-    // Constructor
+    // Constructor (count + mean only, e.g. legacy CSV rows)
     UserActionProfile(string name = "",
                       int freq = 0,
                       double avg = 0.0)
-        : processName(name),
-          frequency(freq),
-          avgDuration(avg) {}
+        : DurationStats(freq, avg),
+          processName(name) {}
+
+    // Constructor from a full summary
+    UserActionProfile(string name, const DurationStats& stats)
+        : DurationStats(stats),
+          processName(name) {}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,111 @@
+#ifndef ACTION_LOG_WRITER_H
+#define ACTION_LOG_WRITER_H
+
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "user_action.h"
+using namespace std;
+
+/*
+ * ActionLogWriter
+ * ---------------
+ * Long-lived, buffered appender for the text action log.
+ * Writes exactly the same lines as FileIO::saveAction, but keeps the
+ * descriptor open and groups many records into one write() call.
+ * Provides:
+ * - append(): formats an action into the buffer
+ * - flush(): writes the buffer (and syncs according to the policy)
+ * - flushIfDue(): time-based flush for callers with an idle loop
+ * - getStats(): throughput, flush latency and bytes-written counters
+ *
+ * A flush happens when the buffer reaches its size limit, when the flush
+ * interval has elapsed (checked on append/flushIfDue), or on request.
+ *
+ * A failed write (EIO, ENOSPC, ...) keeps the unwritten bytes buffered, so
+ * the next flush retries them. Only if the backlog grows past
+ * ACTION_LOG_MAX_BACKLOG buffers, or the log is closed with bytes still
+ * unwritten, are they discarded, and counted in bytesDropped. Whole lines
+ * are dropped, so a line that was half written is finished or terminated
+ * rather than left torn. A failed sync is retried by the next flush.
+ */
+
+const size_t ACTION_LOG_MAX_BACKLOG = 8;   // Buffer limits kept across failed flushes
+
+// How hard a flush tries to make data survive a crash
+enum class DurabilityPolicy {
+    NoSync,             // write() only, the kernel decides when it hits disk
+    FsyncPerBatch,      // fsync() after every flushed batch
+    FdatasyncInterval   // fdatasync() at most once per sync interval
+};
+
+struct ActionLogWriterStats {
+    uint64_t records;          // Actions appended
+    uint64_t bytesWritten;     // Bytes handed to write()
+    uint64_t flushes;          // Non-empty batches written
+    uint64_t syncs;            // fsync/fdatasync calls
+    uint64_t failedFlushes;    // Flushes whose write or sync failed
+    uint64_t bytesDropped;     // Buffered bytes given up after failed writes
+    double totalFlushMicros;   // Sum of flush latencies (write + sync)
+    double maxFlushMicros;     // Worst single flush
+    double elapsedSeconds;     // Time since open()
+
+    ActionLogWriterStats()
+        : records(0), bytesWritten(0), flushes(0), syncs(0), failedFlushes(0), bytesDropped(0),
+          totalFlushMicros(0.0), maxFlushMicros(0.0), elapsedSeconds(0.0) {}
+
+    double recordsPerSecond() const { return elapsedSeconds > 0 ? records / elapsedSeconds : 0.0; }
+    double bytesPerSecond() const { return elapsedSeconds > 0 ? bytesWritten / elapsedSeconds : 0.0; }
+    double avgFlushMicros() const { return flushes ? totalFlushMicros / flushes : 0.0; }
+};
+
+class ActionLogWriter {
+private:
+    typedef chrono::steady_clock Clock;
+
+    int fd;
+    string buffer;
+    size_t bufferLimit;
+    chrono::milliseconds flushInterval;
+    chrono::milliseconds syncInterval;
+    DurabilityPolicy policy;
+
+    Clock::time_point openedAt;
+    Clock::time_point lastFlush;
+    Clock::time_point lastSync;
+    bool dirtySinceSync;
+    bool midLine;           // The log ends in a partially written line
+    mutable ActionLogWriterStats stats;
+
+    bool writeAll(const char* data, size_t len, size_t& written);
+    bool sync(bool force);
+    void dropBuffer(bool all);
+
+public:
+    ActionLogWriter(size_t bufferBytes = 1 << 20,
+                    int flushIntervalMs = 1000,
+                    DurabilityPolicy durability = DurabilityPolicy::NoSync,
+                    int syncIntervalMs = 1000);
+    ~ActionLogWriter();
+
+    ActionLogWriter(const ActionLogWriter&) = delete;
+    ActionLogWriter& operator=(const ActionLogWriter&) = delete;
+
+    // Opens (creating if needed) the log in append mode
+    bool open(const string& filename);
+    bool isOpen() const { return fd >= 0; }
+
+    // Buffers one action; may trigger a size- or time-based flush
+    bool append(const UserAction& action);
+    // Flushes only if the flush interval has elapsed since the last flush
+    bool flushIfDue();
+    // Writes all buffered records now; on failure the rest stays buffered
+    bool flush();
+    // Flushes, syncs (unless NoSync) and closes the descriptor
+    bool close();
+
+    const ActionLogWriterStats& getStats() const;
+};
+
+#endif
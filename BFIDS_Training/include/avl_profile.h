@@ -2,9 +2,19 @@
 #define A24A5966_2E58_4AB3_BF14_A5239420D819
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
 #include <functional>
+#include <utility>
 #include "UserActionProfile.h"
 
+class FrozenProfile;
+struct PageCacheStats;
+
+// One training sample (process name, duration) for AVLProfile::insertOrUpdateBatch
+typedef std::pair<std::string_view, double> DurationSample;
+
 /*
  * AVLProfile
  * ----------
@@ -15,54 +25,160 @@
  * - Persistence: Export/Import the tree structure to CSV/Disk.
  *
  * Node stores:
- * UserActionProfile { processName, frequency, avgDuration }
+ * UserActionProfile { processName, DurationStats (frequency, avgDuration, spread) }
+ * Nodes sit in one pool and link by 32-bit index; names sit in one
+ * character arena. Insert and search are iterative, and tearing the
+ * tree down is just releasing the two buffers.
  */
 class AVLProfile {
 public:
     AVLProfile();
     ~AVLProfile();
 
-    // TRAINING: Insert new process or update avgDuration + frequency
-    void insertOrUpdate(const std::string& processName, double duration);
+    // Profiles can be large; copies must be explicit (mergeFrom)
+    AVLProfile(const AVLProfile&) = delete;
+    AVLProfile& operator=(const AVLProfile&) = delete;
+
+    // TRAINING: Insert new process or update its DurationStats in O(1)
+    // (string_view keys: parsed slices and literals need no temporary string)
+    void insertOrUpdate(std::string_view processName, double duration);
+
+    // TRAINING (batched): samples are first folded per distinct name, then
+    // each name gets one merged update, so the tree is walked once per name
+    // instead of once per sample. Same statistics as calling insertOrUpdate
+    // in order (mean and M2 up to floating-point rounding).
+    void insertOrUpdateBatch(const DurationSample* samples, size_t count);
+    void insertOrUpdateBatch(const std::vector<DurationSample>& samples);
 
-    // IMPORT: Direct insert of a full profile (frequency, avgDuration)
+    // IMPORT: Direct insert of a full profile (all DurationStats fields)
     void insertProfileDirect(const UserActionProfile& profile);
 
-    // SEARCH: Returns true if process exists in fingerprint
-    bool search(const std::string& processName, UserActionProfile& outProfile) const;
+    // BULK LOAD: Builds a perfectly balanced tree in O(n) from sorted profiles.
+    // Unsorted input is sorted first (later duplicates win, as with insertProfileDirect).
+    // On a non-empty tree it falls back to inserting one by one.
+    void bulkLoad(std::vector<UserActionProfile>& profiles);
+
+    // MERGE: Combine a partial profile (DurationStats::merge: counts, means, M2, sketch)
+    void mergeProfile(const UserActionProfile& profile);
+    void mergeFrom(const AVLProfile& other);
+
+    // TRAVERSAL: Visit every profile in processName order
+    void forEach(const std::function<void(const UserActionProfile&)>& fn) const;
+
+    // SEARCH: Returns true if process exists in fingerprint.
+    // Does not allocate once outProfile.processName has enough capacity.
+    bool search(std::string_view processName, UserActionProfile& outProfile) const;
+    // SEARCH (stats only): never allocates
+    bool search(std::string_view processName, int& frequency, double& avgDuration) const;
+
+    // ORDERED ACCESS: in-order cursor over (processName, stats).
+    // Positioning is O(log n), each next() is O(1) amortized, no recursion.
+    // A cursor is invalidated by any change to the profile.
+    class Cursor {
+    public:
+        bool valid() const { return top > 0; }
+        void next();
+        std::string_view key() const;
+        const DurationStats& stats() const;
+
+    private:
+        friend class AVLProfile;
+        const AVLProfile* owner;
+        uint32_t stack[64];     // Ancestors still to visit; the top is the current entry
+        int top;
+
+        explicit Cursor(const AVLProfile* o) : owner(o), top(0) {}
+        void pushLeftSpine(uint32_t n);
+    };
+
+    Cursor begin() const;
+    // First entry whose processName is >= key
+    Cursor lowerBound(std::string_view key) const;
+    // Visit entries starting with prefix / in [from, to), in order; O(log n + k).
+    // Both return the number of entries visited.
+    size_t scanPrefix(std::string_view prefix,
+                      const std::function<void(std::string_view, const DurationStats&)>& fn) const;
+    size_t scanRange(std::string_view from, std::string_view to,
+                     const std::function<void(std::string_view, const DurationStats&)>& fn) const;
+
+    // Number of distinct processes
+    size_t size() const { return nodes.size(); }
+    // Drops every entry in O(1) (the arena is released, nodes are not visited)
+    void clear();
+
+    // DETECTION: Immutable, cache-friendly copy for lookups (frozen_profile.h)
+    FrozenProfile freeze() const;
 
     // PERSISTENCE
+    // Also writes the paged name -> row offset index (indexPathFor)
     bool exportToCSV(const std::string& filename) const;
     bool importFromCSV(const std::string& filename);
+    // "x.csv" -> "x_index.bin"
+    static std::string indexPathFor(const std::string& csvFilename);
+    // One row of a CSV fingerprint without loading it: through the index
+    // when it matches the CSV, otherwise by scanning. io (optional)
+    // receives the index page-cache counters, scanned (optional) whether
+    // the lookup fell back to scanning the CSV.
+    static bool findInCSV(const std::string& filename, std::string_view processName,
+                          UserActionProfile& out, PageCacheStats* io = nullptr,
+                          bool* scanned = nullptr);
+    // Binary fingerprint (fingerprint_file.h): sorted records + string pool
+    bool exportToBinary(const std::string& filename) const;
+    // Same bytes as exportToBinary, into memory (e.g. to write them elsewhere)
+    void encodeBinary(std::string& out) const;
+    bool importFromBinary(const std::string& filename);
 
 private:
-    struct Node {
-        UserActionProfile profile;
-        Node* left;
-        Node* right;
-        int height;
+    static const uint32_t NIL = 0xFFFFFFFFu;   // "No child" index
 
-        Node(const UserActionProfile& p)
-            : profile(p), left(nullptr), right(nullptr), height(1) {}
+    // Index-linked node. The full key lives in keyArena; its first 16 bytes
+    // are also kept inline (big-endian, zero padded) so most comparisons
+    // are two integer compares that never leave the node. The statistics
+    // sit in a parallel array, so descending the tree never touches them.
+    struct Node {
+        uint64_t prefix[2];
+        uint32_t keyOffset;     // Start of processName in keyArena
+        uint32_t keyLength;
+        uint32_t left;
+        uint32_t right;
+        int32_t height;
     };
 
-    Node* root;
+    // Search key with its inline prefix computed once per operation
+    struct Probe {
+        std::string_view name;
+        uint64_t prefix[2];
+        explicit Probe(std::string_view s);
+    };
 
-    // AVL Helpers
-    int height(Node* n) const;
-    int getBalance(Node* n) const;
+    std::vector<Node> nodes;    // Node pool; index = node id
+    std::vector<DurationStats> stats;   // stats[id] belongs to nodes[id]
+    std::vector<char> keyArena; // Process names, back to back
+    uint32_t root;
 
-    Node* rightRotate(Node* y);
-    Node* leftRotate(Node* x);
+    // Key of a node as a view into the arena
+    std::string_view key(uint32_t n) const {
+        return std::string_view(keyArena.data() + nodes[n].keyOffset, nodes[n].keyLength);
+    }
+    UserActionProfile toProfile(uint32_t n) const;
+    int compare(const Probe& probe, uint32_t n) const;
 
-    Node* insertOrUpdateNode(Node* node, const std::string& processName, double duration);
-    Node* insertProfileNode(Node* node, const UserActionProfile& profile);
+    // AVL Helpers
+    int height(uint32_t n) const;
+    int getBalance(uint32_t n) const;
+    void updateHeight(uint32_t n);
 
-    Node* findNode(Node* node, const std::string& processName) const;
+    uint32_t rightRotate(uint32_t y);
+    uint32_t leftRotate(uint32_t x);
+    uint32_t rebalance(uint32_t n);
+    // Links pool nodes [lo, hi), already in key order, into a balanced subtree
+    uint32_t linkBalanced(uint32_t lo, uint32_t hi);
 
-    void inorderExport(Node* node, const std::function<void(const UserActionProfile&)>& fn) const;
+    uint32_t newNode(const Probe& probe, const DurationStats& initial);
 
-    void destroy(Node* node);
+    // Finds processName or inserts it with zeroed stats; returns its node id
+    uint32_t findOrInsert(std::string_view processName);
+    uint32_t findNode(std::string_view processName) const;
 };
 
 #endif
\ No newline at end of file
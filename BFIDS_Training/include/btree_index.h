@@ -2,54 +2,107 @@
 #define BTREE_INDEX_H
 
 #include <string>
-#include <iostream>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <utility>
 #include <stddef.h>
+#include <stdint.h>
 
-// Minimum degree T (T=3 is common, means 5 keys max, 6 children max)
-#define T 3
-#define MAX_KEYS (2 * T - 1)
-#define MAX_CHILDREN (2 * T)
+// Minimum degree t: a node holds t-1 .. 2t-1 keys and up to 2t children.
+// 3 was the original fixed value; larger degrees keep more keys per cache
+// line walk (see btree_bench).
+const int BTREE_DEFAULT_DEGREE = 16;
+const int BTREE_MAX_DEGREE = 128;
+
+// One (key, value) pair for bulk builds, BTreeIndex::bulkLoad / DiskBTree::bulkLoad
+typedef std::pair<std::string_view, uint64_t> IndexEntry;
 
 /*
  * BTreeIndex
  * ----------
  * Implements a B-Tree for efficient indexing and searching of process names.
  * Provides:
- * - insert(): adds a key to the index
- * - search(): checks if a key exists in the index
+ * - insert(): adds a key (and the value it maps to) to the index,
+ *   or overwrites the value of an existing key
+ * - search() / find(): checks if a key exists, optionally returning its value
+ * - bulkLoad(): builds the tree from sorted keys in O(n), bottom-up
+ * - forEach(): every key in order (used to write the paged copy, disk_btree.h)
+ *
+ * Node stores (node i owns the slots [i * maxKeys, (i + 1) * maxKeys)):
+ * prefixes[] { first 16 key bytes, big-endian }   <- searched
+ * entries[]  { hash, key offset/length, value }   <- read on a candidate
+ * children[] { node indices }, plus a count and a leaf flag per node
  *
- * Node stores:
- * BTreeNode { keys[], children[], leaf_flag }
+ * The search inside a node is a branch-free binary search over the
+ * prefixes only, which sit packed together; the full key (in keyArena)
+ * is compared only when the prefixes tie, and the hash filters the
+ * equality check.
  */
+class BTreeIndex {
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
 
-struct BTreeNode {
-    // **Fixed-size Array** of keys
-    std::string keys[MAX_KEYS];
+    struct KeyPrefix {
+        uint64_t hi;
+        uint64_t lo;
 
-    // **Fixed-size Array** of child pointers
-    BTreeNode* children[MAX_CHILDREN];
+        bool operator==(const KeyPrefix& o) const { return hi == o.hi && lo == o.lo; }
+    };
 
-    int n; // Current number of keys
-    bool leaf;
+    struct Entry {
+        uint64_t value;
+        uint32_t hash;
+        uint32_t keyOffset;     // In keyArena
+        uint32_t keyLength;
+    };
 
-    BTreeNode(bool leaf_flag);
-};
+    struct NodeInfo {
+        uint16_t n;             // Current number of keys
+        bool leaf;
+    };
 
-class BTreeIndex {
-private:
-    BTreeNode* root;
+    int t;                      // Minimum degree
+    int maxKeys;                // 2t - 1
+    uint32_t root;
+    size_t count;
+
+    std::vector<NodeInfo> info;
+    std::vector<KeyPrefix> prefixes;
+    std::vector<Entry> entries;
+    std::vector<uint32_t> children;     // maxKeys + 1 per node
+    std::vector<char> keyArena;
 
-    void insertNonFull(BTreeNode* x, const std::string& k);
-    void splitChild(BTreeNode* x, int i, BTreeNode* y);
-    BTreeNode* searchNode(BTreeNode* x, const std::string& k);
+    static KeyPrefix prefixOf(std::string_view k);
+    static uint32_t hashOf(std::string_view k);
+
+    uint32_t newNode(bool leaf);
+    std::string_view keyAt(size_t slot) const;
+    int lowerBound(uint32_t x, const KeyPrefix& kp, std::string_view k) const;
+    bool matches(size_t slot, const KeyPrefix& kp, uint32_t kh, std::string_view k) const;
+    void moveSlot(size_t from, size_t to);
+    void splitChild(uint32_t x, int i);
+    void forEachNode(uint32_t x, const std::function<void(std::string_view, uint64_t)>& fn) const;
 
 public:
-    BTreeIndex() : root(nullptr) {}
-    void insert(const std::string& k);
-    bool search(const std::string& k);
+    // minDegree is clamped to [2, BTREE_MAX_DEGREE]
+    explicit BTreeIndex(int minDegree = BTREE_DEFAULT_DEGREE);
+
+    void insert(std::string_view k, uint64_t value = 0);
+    // Replaces the contents with sorted (strictly increasing) entries,
+    // filling nodes to fill * (2t - 1) keys; lower it if inserts will
+    // follow. False (index left empty) if the input is not sorted.
+    bool bulkLoad(const std::vector<IndexEntry>& sorted, double fill = 1.0);
+    bool search(std::string_view k) const;
+    bool find(std::string_view k, uint64_t& value) const;
+    void forEach(const std::function<void(std::string_view, uint64_t)>& fn) const;
 
-    void destroy(BTreeNode* node);
-    ~BTreeIndex() { destroy(root); }
+    size_t size() const { return count; }
+    int minDegree() const { return t; }
+    // Bytes held by the node arrays and the key arena
+    size_t memoryUsage() const;
+    // Drops every key; the degree is kept
+    void clear();
 };
 
-#endif
\ No newline at end of file
+#endif
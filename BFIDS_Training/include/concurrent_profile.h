@@ -0,0 +1,151 @@
+#ifndef CONCURRENT_PROFILE_H
+#define CONCURRENT_PROFILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "UserActionProfile.h"
+
+class AVLProfile;
+
+/*
+ * ConcurrentProfile
+ * -----------------
+ * Fingerprint that can be retrained while monitors keep reading it.
+ * Provides:
+ * - snapshot(): a read guard on the current immutable version; lookups
+ *   through it never take a lock and never wait for writers
+ * - insertOrUpdate() / mergeProfile(): queue updates (thread-safe)
+ * - publish(): applies the queued batch to a new version and makes it
+ *   current with one atomic pointer swap
+ *
+ * Versions are persistent AVL trees. A batch copies only the nodes on the
+ * paths it touches (path copying); everything else is shared with the
+ * previous version. Nodes already copied by the same batch are updated in
+ * place, so a batch costs at most one copy per touched node.
+ *
+ * Old versions are reclaimed RCU-style: readers register in one of two
+ * epoch counters and each publish flips the epoch. A reader may load a
+ * version long after registering (several flips later), so it can sit in
+ * either counter: a retired version is freed only once both counters have
+ * been seen at zero since it was retired (a two-flip grace period).
+ * Snapshots should be short-lived; a long-held snapshot only delays
+ * reclamation, it never blocks anyone.
+ */
+class ConcurrentProfile {
+private:
+    struct Node {
+        std::string_view key;   // Points into the key arena (stable)
+        Node* left;
+        Node* right;
+        int height;
+        uint32_t refs;          // Parents (or versions) referencing this node; writer-only
+        uint64_t batch;         // Batch that created it: same batch may mutate in place
+        DurationStats stats;    // Last, so a descent only reads the first cache line
+    };
+
+    struct Version {
+        Node* root;
+        size_t size;
+    };
+
+    struct Retired {
+        Version* version;
+        bool drained[2];        // Reader counter seen at zero since retirement
+    };
+
+    // One queued update: a single sample, or a partial profile to merge
+    struct PendingUpdate {
+        uint32_t keyOffset;     // Into pendingKeys
+        uint32_t keyLength;
+        double duration;
+        int32_t mergeIndex;     // -1 for a sample, else index into pendingMerges
+    };
+
+    // Published state (read by readers)
+    std::atomic<Version*> current;
+    mutable std::atomic<uint64_t> epoch;
+    mutable std::atomic<int64_t> readers[2];
+
+    // Writer state (guarded by writeLock)
+    mutable std::mutex writeLock;
+    std::vector<PendingUpdate> pending;
+    std::string pendingKeys;
+    std::vector<DurationStats> pendingMerges;
+    std::vector<Retired> retired;
+    std::vector<std::unique_ptr<char[]>> keyChunks;
+    size_t chunkUsed;
+    size_t chunkSize;
+    uint64_t batchId;
+    size_t workingSize;
+
+    std::string_view internKey(std::string_view key);
+    Node* newLeaf(std::string_view key);
+    Node* own(Node* n);
+    static void incRef(Node* n);
+    static void decRef(Node* n);
+    static int height(const Node* n) { return n ? n->height : 0; }
+    static void updateHeight(Node* n);
+    Node* rightRotate(Node* y);
+    Node* leftRotate(Node* x);
+    Node* rebalance(Node* n);
+    Node* apply(Node* n, std::string_view key, const PendingUpdate& u);
+    Node* buildBalanced(const std::vector<UserActionProfile>& sorted, size_t lo, size_t hi);
+    void publishVersion(Version* next);
+    void reclaim(bool all);
+
+public:
+    ConcurrentProfile();
+    ~ConcurrentProfile();
+
+    ConcurrentProfile(const ConcurrentProfile&) = delete;
+    ConcurrentProfile& operator=(const ConcurrentProfile&) = delete;
+
+    // Read guard on one immutable version
+    class Snapshot {
+    private:
+        const ConcurrentProfile* owner;
+        const Version* version;
+        int parity;
+
+        friend class ConcurrentProfile;
+        Snapshot(const ConcurrentProfile* o, const Version* v, int p) : owner(o), version(v), parity(p) {}
+
+    public:
+        Snapshot(Snapshot&& other) noexcept;
+        Snapshot& operator=(Snapshot&&) = delete;
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        ~Snapshot();
+
+        // nullptr if the process is unknown in this version
+        const DurationStats* find(std::string_view processName) const;
+        bool search(std::string_view processName, UserActionProfile& outProfile) const;
+        // In processName order
+        void forEach(const std::function<void(const UserActionProfile&)>& fn) const;
+        size_t size() const { return version->size; }
+    };
+
+    // READERS: never block
+    Snapshot snapshot() const;
+
+    // WRITERS: queue updates, then publish them as one new version
+    void insertOrUpdate(std::string_view processName, double duration);
+    void mergeProfile(const UserActionProfile& profile);
+    // Applies every queued update; returns how many were applied
+    size_t publish();
+
+    // Replaces the whole content with a trained profile (one new version)
+    void loadFrom(const AVLProfile& profile);
+
+    // Frees retired versions whose readers have finished
+    void reclaim();
+};
+
+#endif
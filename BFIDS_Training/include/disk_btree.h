@@ -0,0 +1,191 @@
+#ifndef DISK_BTREE_H
+#define DISK_BTREE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "btree_index.h"
+using namespace std;
+
+/*
+ * PageCache
+ * ---------
+ * Fixed-size page file with a small write-back cache.
+ * Provides:
+ * - read() / write(): a page through the cache (least recently used
+ *   frame is evicted, written back first if dirty)
+ * - allocate() / release(): pages come from the free-list before the
+ *   file is extended; released pages are pushed onto it
+ * - flush(): writes every dirty frame and the file header
+ *
+ * Page 0 is the file header: the first PAGE_HEADER_RESERVED bytes belong
+ * to the cache (magic, page size, page count, free-list head), the rest
+ * to the owner (see DiskBTree). A free page stores the next free page id
+ * in its first 4 bytes; 0 ends the list.
+ *
+ * Pointers returned by read()/write() are valid until the next call that
+ * may load a page (read, write, allocate, release).
+ */
+
+const size_t DISK_PAGE_SIZE = 4096;
+const size_t PAGE_HEADER_RESERVED = 32;
+
+struct PageCacheStats {
+    uint64_t hits;       // Requests served from a cached frame
+    uint64_t reads;      // Pages read from the file
+    uint64_t writes;     // Pages written back
+
+    PageCacheStats() : hits(0), reads(0), writes(0) {}
+};
+
+class PageCache {
+private:
+    struct Frame {
+        uint32_t page;
+        bool dirty;
+        uint64_t lastUse;
+        unique_ptr<char[]> data;
+    };
+
+    int fd;
+    bool writable;
+    size_t capacity;
+    vector<Frame> frames;
+    unordered_map<uint32_t, size_t> lookup;    // page -> frame
+    uint64_t tick;
+    uint32_t pageCount;
+    uint32_t freeHead;
+    PageCacheStats stats;
+
+    Frame* fetch(uint32_t page, bool load);
+    bool writeBack(Frame& f);
+
+public:
+    explicit PageCache(size_t capacityPages = 64);
+    ~PageCache();
+
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    // create=true starts an empty file (header page only)
+    bool open(const string& path, bool create, bool writable);
+    bool flush();
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    const char* read(uint32_t page);
+    char* write(uint32_t page);
+    // Zero-filled page, from the free-list if possible; 0 on failure
+    uint32_t allocate();
+    void release(uint32_t page);
+
+    uint32_t size() const { return pageCount; }
+    const PageCacheStats& getStats() const { return stats; }
+    void resetStats() { stats = PageCacheStats(); }
+};
+
+/*
+ * DiskBTree
+ * ---------
+ * Paged B+Tree from string keys to 64-bit values, stored in a PageCache
+ * file. Internal pages hold separator keys and child page ids; leaf pages
+ * hold the entries and link to their right sibling.
+ * Provides:
+ * - insert(): add or overwrite a key
+ * - bulkLoad(): fills an empty tree from sorted entries in O(n), writing
+ *   each page once
+ * - find(): point lookup, reads height() pages
+ * - erase(): removes a key; a page that becomes empty is unlinked and
+ *   returned to the free-list (no merging of half-empty pages)
+ * - forEach(): every entry in key order along the leaf chain
+ *
+ * Node page layout (slotted):
+ *   header : u8 leaf | u8 pad | u16 count | u32 next leaf | u64 child0
+ *   slots  : count x { u16 keyOffset, u16 keyLength, u32 pad, u64 value }
+ *   keys   : packed from the end of the page towards the slots
+ * In a leaf, value is the entry's value; in an internal page it is the
+ * child holding keys >= that slot's key (child0 holds smaller keys).
+ * Lookups and most inserts work on the slots in place; only splits and
+ * erases decode a page.
+ *
+ * Every node page is validated when it is read (slot and key bounds,
+ * child ids, leaf flag against its level). A page that fails makes the
+ * operation fail and sets isDamaged(); callers should then treat the
+ * file as absent rather than trust its answers.
+ */
+
+const size_t DISK_BTREE_MAX_KEY = 1024;     // Keeps >= 3 entries per page
+
+class DiskBTree {
+private:
+    struct Node {
+        bool leaf;
+        uint32_t next;
+        uint64_t child0;
+        vector<string> keys;
+        vector<uint64_t> values;
+
+        size_t bytes() const;
+    };
+
+    PageCache pages;
+    uint32_t root;
+    uint32_t levels;
+    uint64_t count;
+    uint64_t tag;
+    bool writable;
+    bool damaged;
+
+    const char* readNode(uint32_t page, bool leaf);
+    char* writableNode(uint32_t page, bool leaf);
+    static void decode(const char* page, Node& out);
+    static void encode(const Node& node, char* page);
+    static size_t childSlot(const char* page, string_view key);
+    bool writeNode(uint32_t page, const Node& node);
+    bool writeMeta();
+    bool insertSeparator(vector<uint32_t>& path, string_view key, uint64_t child);
+    bool packLevel(const vector<IndexEntry>& items, bool leaf, size_t budget, vector<IndexEntry>& parents);
+    bool unlinkChild(vector<uint32_t>& path, vector<size_t>& slots);
+    uint32_t leafFor(string_view key, vector<uint32_t>* path, vector<size_t>* slots);
+
+public:
+    explicit DiskBTree(size_t cachePages = 64);
+    ~DiskBTree();
+
+    DiskBTree(const DiskBTree&) = delete;
+    DiskBTree& operator=(const DiskBTree&) = delete;
+
+    // Creates (truncates) an index file, open for writing
+    bool create(const string& path);
+    // Opens an existing index file; false if missing or not an index
+    bool open(const string& path, bool writable = false);
+    bool close();
+
+    bool insert(string_view key, uint64_t value);
+    // Only on an empty tree: packs sorted (strictly increasing) entries
+    // into pages filled to fill * DISK_PAGE_SIZE bytes, then builds the
+    // internal levels bottom-up. False if unsorted or a key is too long.
+    bool bulkLoad(const vector<IndexEntry>& sorted, double fill = 1.0);
+    bool find(string_view key, uint64_t& value);
+    bool erase(string_view key);
+    void forEach(const function<void(string_view, uint64_t)>& fn);
+
+    uint64_t size() const { return count; }
+    uint32_t height() const { return levels; }
+    // Caller-defined stamp stored in the header (e.g. what the values point into)
+    uint64_t getTag() const { return tag; }
+    void setTag(uint64_t t) { tag = t; }
+
+    const PageCacheStats& cacheStats() const { return pages.getStats(); }
+    void resetCacheStats() { pages.resetStats(); }
+    uint32_t pageCount() const { return pages.size(); }
+    // A page failed validation since open(); results so far are not reliable
+    bool isDamaged() const { return damaged; }
+};
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef DURATION_STATS_H
+#define DURATION_STATS_H
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+/*
+ * DurationStats
+ * -------------
+ * Streaming summary of the durations seen for one process.
+ * Every field is updated in O(1) per sample and no samples are kept.
+ * Provides:
+ * - add(): Welford update of mean/M2, min/max, and the histogram sketch
+ * - merge(): exact combination of two summaries (Chan et al. for M2)
+ * - stddev() / percentile(): spread of the distribution
+ * - lowerBound() / upperBound(): detection limits for the monitors
+ *
+ * Sketch: DURATION_BUCKETS log2 buckets; bucket b holds durations in
+ * [2^(b + DURATION_MIN_EXP), 2^(b + DURATION_MIN_EXP + 1)), the first and
+ * last bucket also take everything below/above. Percentiles interpolate
+ * geometrically inside a bucket and are clamped to [min, max].
+ */
+
+const int DURATION_BUCKETS = 24;
+const int DURATION_MIN_EXP = -4;          // Bucket 0 starts at 2^-4 = 0.0625
+const int DURATION_MIN_SAMPLES = 30;      // Below this, detection uses the classic mean-based limits
+
+struct DurationStats {
+    int frequency;        // How many times process occurred
+    double avgDuration;   // Rolling average duration
+    double m2;            // Sum of squared deviations from the mean (Welford)
+    double minDuration;
+    double maxDuration;
+    uint32_t buckets[DURATION_BUCKETS];
+
+    DurationStats(int freq = 0, double avg = 0.0)
+        : frequency(freq), avgDuration(avg), m2(0.0), minDuration(avg), maxDuration(avg) {
+        std::fill(buckets, buckets + DURATION_BUCKETS, 0u);
+        // Summaries known only by count and mean: put the mass at the mean
+        if (freq > 0) buckets[bucketOf(avg)] = (uint32_t)freq;
+    }
+
+    static int bucketOf(double d) {
+        if (!(d > 0.0)) return 0;
+        int b = (int)std::floor(std::log2(d)) - DURATION_MIN_EXP;
+        return std::max(0, std::min(DURATION_BUCKETS - 1, b));
+    }
+
+    void add(double d) {
+        if (frequency == 0 || d < minDuration) minDuration = d;
+        if (frequency == 0 || d > maxDuration) maxDuration = d;
+        frequency++;
+        double delta = d - avgDuration;
+        avgDuration += delta / frequency;
+        m2 += delta * (d - avgDuration);
+        buckets[bucketOf(d)]++;
+    }
+
+    void merge(const DurationStats& o) {
+        if (o.frequency <= 0) return;
+        if (frequency <= 0) {
+            *this = o;
+            return;
+        }
+        double n = (double)frequency + o.frequency;
+        double delta = o.avgDuration - avgDuration;
+        m2 += o.m2 + delta * delta * ((double)frequency * o.frequency / n);
+        avgDuration = (avgDuration * frequency + o.avgDuration * o.frequency) / n;
+        frequency += o.frequency;
+        minDuration = std::min(minDuration, o.minDuration);
+        maxDuration = std::max(maxDuration, o.maxDuration);
+        for (int b = 0; b < DURATION_BUCKETS; b++) buckets[b] += o.buckets[b];
+    }
+
+    // Population variance / standard deviation
+    double variance() const { return frequency > 0 ? std::max(0.0, m2 / frequency) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+
+    // Approximate q-quantile (0 <= q <= 1) from the sketch
+    double percentile(double q) const {
+        uint64_t total = 0;
+        for (int b = 0; b < DURATION_BUCKETS; b++) total += buckets[b];
+        if (total == 0) return avgDuration;
+
+        double rank = q * total;
+        uint64_t seen = 0;
+        for (int b = 0; b < DURATION_BUCKETS; b++) {
+            if (buckets[b] == 0) continue;
+            if (seen + buckets[b] >= rank) {
+                double lo = std::max(minDuration, std::ldexp(1.0, b + DURATION_MIN_EXP));
+                double hi = std::min(maxDuration, std::ldexp(1.0, b + DURATION_MIN_EXP + 1));
+                if (b == 0) lo = minDuration;
+                if (b == DURATION_BUCKETS - 1) hi = maxDuration;
+                if (!(lo > 0.0) || hi <= lo) return std::min(std::max(lo, minDuration), maxDuration);
+                double frac = (rank - seen) / buckets[b];
+                return lo * std::pow(hi / lo, std::min(1.0, std::max(0.0, frac)));
+            }
+            seen += buckets[b];
+        }
+        return maxDuration;
+    }
+
+    // Enough samples with a real spread to trust the distribution?
+    bool hasSpread() const { return frequency >= DURATION_MIN_SAMPLES && maxDuration > minDuration; }
+
+    // Detection limits. Never looser than the classic factor x mean rule,
+    // tighter when the learned distribution is narrow.
+    double upperBound(double factor = 3.0) const {
+        double classic = avgDuration * factor;
+        if (!hasSpread()) return classic;
+        return std::min(classic, std::max(percentile(0.99), avgDuration + 3.0 * stddev()));
+    }
+    double lowerBound(double factor = 0.3) const {
+        double classic = avgDuration * factor;
+        if (!hasSpread()) return classic;
+        return std::max(classic, std::min(percentile(0.01), avgDuration - 3.0 * stddev()));
+    }
+};
+
+/*
+ * DurationSum
+ * -----------
+ * Order-independent accumulator for batch training (train_system).
+ * Durations are rounded to fixed point (DURATION_FIXED_BITS fractional
+ * bits) and summed as 128-bit integers, so add() and merge() are exact
+ * and the final summary is the same however the samples were split or
+ * ordered. Mean and M2 are computed once, in toStats().
+ *
+ * Exact while the sum of squares stays below 2^127, e.g. a trillion
+ * samples of 10^4 ms each; a single duration is clamped to +/-2^38.
+ */
+
+const int DURATION_FIXED_BITS = 24;       // Resolution 2^-24 (~6e-8)
+
+struct DurationSum {
+    uint64_t count;
+    __int128 sum;         // Sum of the fixed-point durations
+    __int128 sumSquares;  // Sum of their squares
+    double minDuration;
+    double maxDuration;
+    uint32_t buckets[DURATION_BUCKETS];
+
+    DurationSum() : count(0), sum(0), sumSquares(0), minDuration(0.0), maxDuration(0.0) {
+        std::fill(buckets, buckets + DURATION_BUCKETS, 0u);
+    }
+
+    static int64_t toFixed(double d) {
+        const double limit = std::ldexp(1.0, 38);
+        if (!(d == d)) d = 0.0;
+        d = std::max(-limit, std::min(limit, d));
+        return (int64_t)std::llround(std::ldexp(d, DURATION_FIXED_BITS));
+    }
+
+    void add(double d) {
+        if (count == 0 || d < minDuration) minDuration = d;
+        if (count == 0 || d > maxDuration) maxDuration = d;
+        count++;
+        __int128 q = toFixed(d);
+        sum += q;
+        sumSquares += q * q;
+        buckets[DurationStats::bucketOf(d)]++;
+    }
+
+    void merge(const DurationSum& o) {
+        if (o.count == 0) return;
+        if (count == 0) {
+            *this = o;
+            return;
+        }
+        count += o.count;
+        sum += o.sum;
+        sumSquares += o.sumSquares;
+        minDuration = std::min(minDuration, o.minDuration);
+        maxDuration = std::max(maxDuration, o.maxDuration);
+        for (int b = 0; b < DURATION_BUCKETS; b++) buckets[b] += o.buckets[b];
+    }
+
+    // M2 = sumSquares - sum^2 / n, exactly in integers when n * sumSquares
+    // fits, else in long double (still a pure function of the sums)
+    DurationStats toStats() const {
+        DurationStats s;
+        if (count == 0) return s;
+        s.frequency = (int)std::min<uint64_t>(count, INT32_MAX);
+        long double n = (long double)count;
+        long double scale = std::ldexp(1.0L, DURATION_FIXED_BITS);
+        s.avgDuration = (double)((long double)sum / n / scale);
+
+        __int128 nSq, sumSq;
+        long double m2Fixed;
+        if (!__builtin_mul_overflow(sumSquares, (__int128)count, &nSq) &&
+            !__builtin_mul_overflow(sum, sum, &sumSq)) {
+            m2Fixed = (long double)(nSq - sumSq) / n;
+        } else {
+            m2Fixed = (long double)sumSquares - (long double)sum * ((long double)sum / n);
+        }
+        s.m2 = (double)std::max(0.0L, m2Fixed / scale / scale);
+        s.minDuration = minDuration;
+        s.maxDuration = maxDuration;
+        std::copy(buckets, buckets + DURATION_BUCKETS, s.buckets);
+        return s;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <unordered_map>
+#include "user_action.h"
+#include "linked_list.h"
+using namespace std;
+
+/*
+ * EventLog (binary columnar format)
+ * ---------------------------------
+ * Compact on-disk alternative to the text action logs.
+ * Provides:
+ * - EventLogWriter: buffers UserActions and writes them as column blocks
+ * - EventLogReader: streams UserActions back out, block by block
+ *
+ * File layout (little-endian):
+ *   Header : "BFEV" | u32 version
+ *   Block* : u32 count | u32 dictSize | dict { u32 len, bytes }...
+ *            | u32 userID[count] | u32 action[count] | u32 process[count]
+ *            | u32 nextAction[count] | u32 status[count]
+ *            | u32 tsBytes | i64 firstTs | zigzag varint deltas...
+ *            | f64 duration[count]
+ *
+ * Every block carries its own string dictionary, so blocks can be
+ * appended to an existing file and a torn final block only loses itself.
+ */
+
+const uint32_t EVENT_LOG_VERSION = 1;
+const size_t EVENT_LOG_DEFAULT_BLOCK = 65536; // Records per column block
+
+class EventLogWriter {
+private:
+    ofstream out;
+    size_t blockCapacity;
+
+    // Pending block (columns)
+    unordered_map<string, uint32_t> dictIndex;
+    vector<string> dict;
+    vector<uint32_t> userIDs, actions, processes, nextActions, statuses;
+    vector<int64_t> timestamps;
+    vector<double> durations;
+
+    uint32_t intern(const string& s);
+    void resetBlock();
+
+public:
+    explicit EventLogWriter(size_t recordsPerBlock = EVENT_LOG_DEFAULT_BLOCK);
+    ~EventLogWriter();
+
+    // Opens a file for writing. With append=true an existing event log is extended
+    // (after cutting off a torn final block).
+    bool open(const string& filename, bool append = false);
+    // Buffers one action; writes a block once blockCapacity records are pending
+    bool append(const UserAction& action);
+    // Writes any pending records as a (possibly short) block
+    bool flush();
+    bool close();
+};
+
+class EventLogReader {
+private:
+    ifstream in;
+
+    // Current decoded block
+    vector<string> dict;
+    vector<uint32_t> userIDs, actions, processes, nextActions, statuses;
+    vector<int64_t> timestamps;
+    vector<double> durations;
+    size_t blockSize;
+    size_t cursor;
+    bool damaged;
+    uint64_t fileSize;      // Bounds every length field read from the file
+
+    bool loadBlock();
+
+public:
+    EventLogReader();
+
+    // Returns true if the file starts with the event log magic
+    static bool isEventLog(const string& filename);
+    // Bytes up to the end of the last block that decodes
+    static uint64_t validLength(const string& filename);
+
+    bool open(const string& filename);
+    void close();
+
+    // Reads the next action; false at end of file or on a damaged block
+    bool next(UserAction& out);
+    // True once a block was truncated or corrupt (next() returned false
+    // before the real end of the file)
+    bool failed() const { return damaged; }
+    // Appends every remaining action to the list, returns how many were read
+    size_t readAll(LinkedList& list);
+};
+
+#endif
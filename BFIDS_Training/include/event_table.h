@@ -0,0 +1,75 @@
+#ifndef EVENT_TABLE_H
+#define EVENT_TABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include "user_action.h"
+#include "symbol_table.h"
+#include "log_parser.h"
+#include "duration_stats.h"
+using namespace std;
+
+/*
+ * EventTable
+ * ----------
+ * Column store (structure of arrays) for large batches of events.
+ * Each field lives in its own contiguous array, so a pass that only needs
+ * timestamps or (process, duration) streams through just those bytes.
+ * Provides:
+ * - append(): adds one event (text fields are interned)
+ * - sortedByTimestamp(): stable permutation of row indices by time
+ * - aggregateByProcess(): per-process DurationSum in one scan
+ * - column accessors for custom scans, row()/toUserAction() for output
+ *
+ * Columns: timestamp | duration | userID | action | processName | nextAction | status
+ */
+class EventTable {
+private:
+    SymbolTable symbols;
+    vector<time_t> timestamps;
+    vector<double> durations;
+    vector<SymbolID> userIDs;
+    vector<SymbolID> actions;
+    vector<SymbolID> processes;
+    vector<SymbolID> nextActions;
+    vector<SymbolID> statuses;
+
+public:
+    EventTable() {}
+
+    EventTable(const EventTable&) = delete;
+    EventTable& operator=(const EventTable&) = delete;
+
+    void reserve(size_t rows);
+    void append(const ActionFields& fields);
+    void append(const UserAction& action);
+    void append(const CompactAction& action);   // ids must come from symbolTable()
+
+    size_t size() const { return timestamps.size(); }
+    bool empty() const { return timestamps.empty(); }
+
+    // Column access (read-only)
+    const time_t* timestampColumn() const { return timestamps.data(); }
+    const double* durationColumn() const { return durations.data(); }
+    const SymbolID* processColumn() const { return processes.data(); }
+    const SymbolID* userColumn() const { return userIDs.data(); }
+
+    SymbolTable& symbolTable() { return symbols; }
+    const SymbolTable& symbolTable() const { return symbols; }
+
+    // Stable ascending-time order of row indices
+    vector<uint32_t> sortedByTimestamp() const;
+
+    // out[id] summarizes the durations of every processName symbol id
+    void aggregateByProcess(vector<DurationSum>& out) const;
+
+    CompactAction row(size_t i) const;
+    UserAction toUserAction(size_t i) const { return symbols.decode(row(i)); }
+
+    // Bytes held by the columns and the symbol table
+    size_t memoryUsage() const;
+};
+
+#endif
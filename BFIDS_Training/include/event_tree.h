@@ -0,0 +1,148 @@
+#ifndef EVENT_TREE_H
+#define EVENT_TREE_H
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include "user_action.h"
+#include "symbol_table.h"
+#include "log_parser.h"
+using namespace std;
+
+/*
+ * EventTree
+ * ---------
+ * In-memory B+Tree of events ordered by (timestamp, sequence).
+ * Provides:
+ * - insert(): adds an event; the sequence number keeps events with the
+ *   same timestamp in arrival order
+ * - scan(): every event with t1 <= timestamp < t2, one descent and then
+ *   along the linked leaves, so only the leaves holding the window are read
+ * - erase(): removes one event; an underfull node borrows from a sibling
+ *   (redistribution) or is merged into it
+ * - eraseRange() / eraseBefore(): bulk delete for retention; a leaf left
+ *   empty is unlinked as a whole instead of being merged entry by entry
+ *
+ * Leaves hold the records (CompactAction, text interned in the tree's
+ * SymbolTable) and link to both neighbours; internal nodes hold only
+ * separator keys and child ids. Nodes sit in two deques (stable
+ * addresses, indexed by 32-bit id) and freed nodes are reused.
+ *
+ * Appends at the right edge (time-ordered logs) split a full node by
+ * moving just the new entry, so the tree stays nearly full instead of
+ * half full.
+ */
+
+const int EVENT_LEAF_MAX = 64;
+const int EVENT_LEAF_MIN = EVENT_LEAF_MAX / 2;
+const int EVENT_INNER_MAX = 128;
+const int EVENT_INNER_MIN = EVENT_INNER_MAX / 2;
+
+struct EventKey {
+    int64_t timestamp;
+    uint64_t sequence;      // Insertion order, unique per tree
+
+    bool operator<(const EventKey& o) const {
+        return timestamp < o.timestamp || (timestamp == o.timestamp && sequence < o.sequence);
+    }
+    bool operator==(const EventKey& o) const { return timestamp == o.timestamp && sequence == o.sequence; }
+};
+
+// Per-scan counters, to see how much of the tree a query touched
+struct EventScanStats {
+    size_t innerVisited;
+    size_t leavesVisited;
+    size_t matched;
+
+    EventScanStats() : innerVisited(0), leavesVisited(0), matched(0) {}
+};
+
+class EventTree {
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Leaf {
+        EventKey keys[EVENT_LEAF_MAX];
+        CompactAction records[EVENT_LEAF_MAX];
+        uint32_t prev;
+        uint32_t next;
+        int n;
+    };
+
+    // Child i holds keys in [keys[i - 1], keys[i])
+    struct Inner {
+        EventKey keys[EVENT_INNER_MAX];
+        uint32_t children[EVENT_INNER_MAX + 1];
+        int n;
+    };
+
+    SymbolTable symbols;
+    deque<Leaf> leaves;
+    deque<Inner> inners;
+    vector<uint32_t> freeLeaves;
+    vector<uint32_t> freeInners;
+    uint32_t root;
+    int levels;             // 1 = the root is a leaf
+    size_t count;
+    size_t leafCount;
+    uint64_t nextSequence;
+    // Descent path reused by insert/erase, so an update allocates nothing
+    vector<uint32_t> pathScratch;
+    vector<int> slotScratch;
+
+    uint32_t newLeaf();
+    uint32_t newInner();
+    void freeLeaf(uint32_t id);
+    void freeInner(uint32_t id);
+
+    static int lowerBound(const Leaf& leaf, const EventKey& k);
+    static int childSlot(const Inner& node, const EventKey& k);
+    uint32_t descend(const EventKey& k, vector<uint32_t>* path, vector<int>* slots,
+                     EventScanStats* stats = nullptr) const;
+
+    void insertKey(const EventKey& k, const CompactAction& record);
+    void insertIntoParent(vector<uint32_t>& path, vector<int>& slots, EventKey separator,
+                          uint32_t right, bool atEnd);
+    void removeChild(Inner& node, int slot);
+    void fixLeaf(vector<uint32_t>& path, vector<int>& slots, uint32_t leaf);
+    void fixInner(vector<uint32_t>& path, vector<int>& slots);
+
+public:
+    EventTree();
+
+    EventTree(const EventTree&) = delete;
+    EventTree& operator=(const EventTree&) = delete;
+
+    EventKey insert(const UserAction& action);
+    EventKey insert(const ActionFields& fields);
+    EventKey insert(const CompactAction& action);   // ids must come from symbolTable()
+
+    // Hands every event with t1 <= timestamp < t2 to fn, in key order;
+    // returns how many
+    size_t scan(time_t t1, time_t t2, const function<void(const EventKey&, const CompactAction&)>& fn,
+                EventScanStats* stats = nullptr) const;
+    void forEach(const function<void(const EventKey&, const CompactAction&)>& fn) const;
+
+    bool erase(const EventKey& key);
+    // Removes every event with t1 <= timestamp < t2; returns how many
+    size_t eraseRange(time_t t1, time_t t2);
+    // Retention: removes every event older than cutoff
+    size_t eraseBefore(time_t cutoff);
+    void clear();
+
+    size_t size() const { return count; }
+    int height() const { return levels; }
+    size_t leafNodes() const { return leafCount; }
+
+    SymbolTable& symbolTable() { return symbols; }
+    const SymbolTable& symbolTable() const { return symbols; }
+    UserAction toUserAction(const CompactAction& record) const { return symbols.decode(record); }
+
+    // Bytes held by the live nodes and the symbol table
+    size_t memoryUsage() const;
+};
+
+#endif
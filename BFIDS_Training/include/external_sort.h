@@ -0,0 +1,70 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include "user_action.h"
+using namespace std;
+
+/*
+ * ExternalActionSorter
+ * --------------------
+ * Sorts any number of UserActions by timestamp within a fixed memory budget.
+ * Provides:
+ * - add(): buffers an action; a full buffer is sorted and spilled as a run
+ * - finish(): k-way merges all runs and hands the actions out in order
+ *
+ * Runs are stored as temporary binary event logs (event_log.h) and removed
+ * when the sorter is finished or destroyed. If everything fits in one run,
+ * no temporary file is written at all.
+ * Ties keep their insertion order (the sort is stable).
+ * Every run must read back with exactly the records written to it; a
+ * truncated or corrupt run makes finish() fail instead of losing them.
+ *
+ * The merge stays within the same budget however many runs there are:
+ * runs are written in blocks of about budget / (SORT_MERGE_FAN_IN + 1)
+ * bytes (a reader decodes one whole block), and with more than
+ * SORT_MERGE_FAN_IN runs, extra passes first merge them into longer
+ * runs, SORT_MERGE_FAN_IN at a time.
+ */
+
+const size_t DEFAULT_SORT_MEMORY = 64u << 20; // 64 MiB of buffered actions
+const size_t SORT_MERGE_FAN_IN = 16;          // Runs open at once while merging
+
+class ExternalActionSorter {
+private:
+    size_t memoryBudget;
+    size_t bufferedBytes;
+    size_t addedBytes;          // Estimated bytes of every action added so far
+    size_t addedCount;
+    vector<UserAction> buffer;
+    vector<string> runFiles;
+    vector<size_t> runCounts;   // Records written to runFiles[i]
+    string tempDir;
+
+    size_t runBlockRecords() const;
+    bool newRunFile(string& path);
+    bool spillRun();
+    bool mergeRuns(size_t first, size_t count, const function<void(const UserAction&)>& fn);
+    void removeRuns();
+
+public:
+    explicit ExternalActionSorter(size_t memoryBytes = DEFAULT_SORT_MEMORY);
+    ~ExternalActionSorter();
+
+    ExternalActionSorter(const ExternalActionSorter&) = delete;
+    ExternalActionSorter& operator=(const ExternalActionSorter&) = delete;
+
+    // Rough heap footprint of one buffered action (struct + long strings)
+    static size_t estimateBytes(const UserAction& action);
+
+    bool add(const UserAction& action);
+    // Emits every action in timestamp order; the sorter is empty afterwards
+    bool finish(const function<void(const UserAction&)>& fn);
+
+    size_t getRunCount() const { return runFiles.size(); }
+};
+
+#endif
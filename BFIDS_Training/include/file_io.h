@@ -5,6 +5,10 @@
 #include <string>
 #include "user_action.h"
 #include "linked_list.h"
+#include "log_parser.h"
+#include "external_sort.h"
+#include "event_table.h"
+#include <vector>
 using namespace std;
 
 /*
@@ -13,9 +17,10 @@ using namespace std;
  * Handles file input/output operations for user actions.
  * Provides:
  * - saveAction(): appends a single action to a file
+ * - appendActionLine(): formats an action as one labelled log line
  * - readFile(): reads and displays file content
- * - saveActionsToFile(): saves a linked list to a file
- * - loadActionsFromFile(): populates a linked list from a file
+ * - saveActionsToFile(): saves a linked list to a file (external merge sort, bounded memory)
+ * - loadActionsFromFile(): populates a linked list from a file (mmap + zero-copy parse)
  *
  * Node stores:
  * Node { UserAction data, next pointer }
@@ -33,12 +38,21 @@ class FileIO {
 public:
     // Saves a single action entry (unformatted, appended)
     static bool saveAction(const UserAction& action, const string& filename);
+    // Appends the "UserID: X, Action: Y, ..." line for an action to out
+    static void appendActionLine(const UserAction& action, string& out);
     // Reads and displays file contents to the console
     static void readFile(const string& filename);
     // Saves a linked list of actions as a formatted, sorted table.
-    // NOTE: Node*& head allows for memory cleanup within the function.
-    static bool saveActionsToFile(Node*& head, const string& filename);
-    static bool loadActionsFromFile(const string& filename, LinkedList& list);
+    // NOTE: Node*& head allows for memory cleanup within the function: the list is
+    // freed (head = nullptr) only after a successful save, and left intact on failure.
+    // memoryBudget caps the bytes of actions sorted in RAM; larger inputs spill sorted runs to disk.
+    static bool saveActionsToFile(Node*& head, const string& filename,
+                                  size_t memoryBudget = DEFAULT_SORT_MEMORY);
+    // Writes the formatted report table; rows are written in the given index order
+    static bool writeActionTable(const EventTable& table, const vector<uint32_t>& order,
+                                 const string& filename);
+    // Loads a raw log into the list; optional stats receive parsed/rejected line counts
+    static bool loadActionsFromFile(const string& filename, LinkedList& list, ParseStats* stats = nullptr);
 };
 
 // Linked list utility: adds a new action node to the end of the list
@@ -0,0 +1,84 @@
+#ifndef FINGERPRINT_FILE_H
+#define FINGERPRINT_FILE_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "log_parser.h"
+#include "duration_stats.h"
+using namespace std;
+
+/*
+ * FingerprintFile (binary fingerprint format)
+ * -------------------------------------------
+ * mmap-loadable alternative to the fingerprint CSV.
+ * Written by AVLProfile::exportToBinary(); read through one read-only
+ * mapping with no parsing and no per-record allocation.
+ *
+ * File layout (little-endian, 8-byte aligned):
+ *   Header  : "BFFP" | u32 version | u64 count | u64 poolBytes
+ *   Records : count x { u32 keyOffset, u32 keyLength, i32 frequency,
+ *                       u32 reserved, f64 avgDuration, f64 m2,
+ *                       f64 minDuration, f64 maxDuration,
+ *                       u32 buckets[DURATION_BUCKETS] }   sorted by key
+ *   Pool    : poolBytes of process names, back to back
+ *
+ * open() checks sizes, pool bounds and strict key order, so consumers can
+ * rely on the records being sorted and unique.
+ */
+
+const uint32_t FINGERPRINT_FILE_VERSION = 2;    // 2: full DurationStats per record
+
+struct FingerprintHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    uint64_t poolBytes;
+};
+
+struct FingerprintRecord {
+    uint32_t keyOffset;     // Start of the name in the pool
+    uint32_t keyLength;
+    int32_t frequency;
+    uint32_t reserved;      // Keeps avgDuration 8-byte aligned
+    double avgDuration;
+    double m2;
+    double minDuration;
+    double maxDuration;
+    uint32_t buckets[DURATION_BUCKETS];
+
+    void setStats(const DurationStats& s);
+    DurationStats toStats() const;
+};
+
+class FingerprintFile {
+private:
+    MappedFile file;
+    const FingerprintRecord* records;
+    const char* pool;
+    size_t count;
+    size_t poolBytes;
+
+public:
+    FingerprintFile() : records(nullptr), pool(nullptr), count(0), poolBytes(0) {}
+
+    static const char MAGIC[4];
+
+    // Binary companion of a fingerprint CSV: "x.csv" -> "x.bfp"
+    static string pathFor(const string& csvPath);
+
+    // Maps and validates the file; false if missing or not a valid fingerprint
+    bool open(const string& filename);
+    void close();
+
+    size_t size() const { return count; }
+    const FingerprintRecord& record(size_t i) const { return records[i]; }
+    string_view key(size_t i) const { return string_view(pool + records[i].keyOffset, records[i].keyLength); }
+
+    // Whole string pool (record keyOffsets index into it)
+    const char* poolData() const { return pool; }
+    size_t poolSize() const { return poolBytes; }
+};
+
+#endif
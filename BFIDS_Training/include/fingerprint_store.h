@@ -0,0 +1,115 @@
+#ifndef FINGERPRINT_STORE_H
+#define FINGERPRINT_STORE_H
+
+#include <string>
+#include <string_view>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "avl_profile.h"
+#include "fingerprint_file.h"
+using namespace std;
+
+/*
+ * FingerprintStore
+ * ----------------
+ * Persistent fingerprint that is saved incrementally.
+ * Files (for base "x.bfp"):
+ *   x.bfp          : base image, same format as AVLProfile::exportToBinary
+ *   x.bfp.journal  : append-only records of profiles changed since the base
+ *   x.bfp.journal.old : journal being folded into the base by a compaction
+ * Provides:
+ * - open(): loads the base and replays the journal(s) on top of it
+ * - insertOrUpdate() / insertOrUpdateBatch() / mergeProfile(): update the
+ *   profile and remember which names are dirty
+ * - flush(): appends one record per dirty name to the journal in a single
+ *   write, so its cost follows the dirty keys, not the profile size; a
+ *   failed append is truncated away and its names stay dirty
+ * - compact(): rewrites the base (in a background thread by default) and
+ *   starts a new journal; flush() triggers it once the journal outgrows
+ *   compactRatio x the base
+ *
+ * Journal layout: "BFJL" | u32 version, then per record:
+ *   u32 keyLength | u32 checksum | FingerprintRecord | key bytes
+ * A record holds the full stats of its name, so replay is "last one wins"
+ * and replaying a record twice is harmless. The checksum (FNV-1a over the
+ * record and key) stops replay at a torn tail, which open() cuts off.
+ *
+ * Compaction: flush, rename the journal to .old, encode the profile in
+ * memory, then (in the background) write base.tmp, fsync, rename it over
+ * the base and delete .old. A crash at any point leaves either the old
+ * base + .old + journal, or the new base + records it already contains.
+ */
+
+const uint32_t FINGERPRINT_JOURNAL_VERSION = 1;
+
+struct FingerprintStoreStats {
+    uint64_t flushes;          // Non-empty journal appends
+    uint64_t recordsWritten;   // Journal records appended
+    uint64_t recordsReplayed;  // Journal records applied by open()
+    uint64_t compactions;      // Base rewrites started
+    size_t baseBytes;          // Size of the base image
+    size_t journalBytes;       // Size of the live journal
+
+    FingerprintStoreStats()
+        : flushes(0), recordsWritten(0), recordsReplayed(0), compactions(0),
+          baseBytes(0), journalBytes(0) {}
+};
+
+class FingerprintStore {
+private:
+    AVLProfile profile;
+    set<string, less<>> dirty;     // Names changed since the last flush
+    string basePath;
+    string journalPath;
+    int journalFd;
+    bool journalTorn;              // A failed append could not be cut off yet
+    bool syncOnFlush;
+    double compactRatio;
+    size_t minCompactBytes;
+    FingerprintStoreStats stats;
+
+    thread compactor;
+    atomic<bool> compactOk;
+
+    void markDirty(string_view processName);
+    bool appendDirty();
+    bool replay(const string& path, bool truncateTail);
+    bool openJournal(bool truncate);
+    void waitForCompaction();
+    static bool writeBase(const string& image, const string& basePath, const string& oldJournal);
+
+public:
+    // compactRatio: compact once journal bytes exceed ratio x base bytes
+    // (and at least minCompactBytes). syncOnFlush: fdatasync every flush.
+    FingerprintStore(double compactRatio = 1.0, size_t minCompactBytes = 1 << 20, bool syncOnFlush = false);
+    ~FingerprintStore();
+
+    FingerprintStore(const FingerprintStore&) = delete;
+    FingerprintStore& operator=(const FingerprintStore&) = delete;
+
+    // Loads base + journal(s). fresh=true discards whatever was stored.
+    // A missing base is an empty profile; an invalid one fails.
+    bool open(const string& basePath, bool fresh = false);
+    // Flushes, waits for a running compaction and closes the journal
+    bool close();
+
+    void insertOrUpdate(string_view processName, double duration);
+    void insertOrUpdateBatch(const DurationSample* samples, size_t count);
+    void insertOrUpdateBatch(const vector<DurationSample>& samples) { insertOrUpdateBatch(samples.data(), samples.size()); }
+    void mergeProfile(const UserActionProfile& p);
+    void insertProfileDirect(const UserActionProfile& p);
+
+    // Appends the dirty names to the journal; may start a compaction
+    bool flush();
+    // Rewrites the base and resets the journal; background=false waits for it
+    bool compact(bool background = true);
+
+    const AVLProfile& getProfile() const { return profile; }
+    size_t dirtyCount() const { return dirty.size(); }
+    const FingerprintStoreStats& getStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef FROZEN_PROFILE_H
+#define FROZEN_PROFILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "UserActionProfile.h"
+
+class AVLProfile;
+
+/*
+ * FrozenProfile
+ * -------------
+ * Immutable, lookup-only copy of a trained AVLProfile (see AVLProfile::freeze()).
+ * Used by the monitors, which never modify the fingerprint while detecting.
+ * Provides:
+ * - loadBinary(): builds the snapshot directly from a .bfp fingerprint
+ * - find(): stats for a process name, or nullptr
+ * - search(): same contract as AVLProfile::search
+ *
+ * Layout: the sorted keys are stored in Eytzinger (BFS) order, so the
+ * children of slot k are slots 2k and 2k+1 and the top levels of every
+ * search share the same few cache lines. Each 32-byte slot holds:
+ * - hash   : 64-bit FNV-1a of the full key, checked first at every level
+ * - prefix : first 16 key bytes, big-endian, which decide the branch
+ *            (the arena is only read when two keys share those 16 bytes)
+ * - key location in the arena
+ * The 4 grandchildren of slot k fill one 128-byte block, which is
+ * prefetched while slot k is compared. Stats live in a parallel array
+ * that is touched once, on a hit.
+ */
+
+class FrozenProfile {
+private:
+    struct Slot {
+        uint64_t hash;
+        uint64_t prefix[2];     // First 16 bytes, big-endian, zero padded
+        uint32_t keyOffset;     // Start of the name in keyArena
+        uint32_t keyLength;
+    };
+
+    // Slot 0 is unused so that the children of k are 2k and 2k+1
+    Slot* slots;                // 128-byte aligned, n + 1 entries
+    std::vector<DurationStats> stats;
+    std::vector<char> keyArena;
+    size_t n;
+
+    void release();
+    void allocate(size_t count);
+    void place(size_t k, std::string_view key, uint32_t keyOffset, const DurationStats& s);
+    // In-order walk of the implicit tree; put(k, i) stores sorted item i in slot k
+    template <typename Put>
+    size_t fill(size_t next, size_t k, Put& put);
+    size_t locate(std::string_view processName) const;
+
+public:
+    FrozenProfile();
+    ~FrozenProfile();
+
+    FrozenProfile(FrozenProfile&& other) noexcept;
+    FrozenProfile& operator=(FrozenProfile&& other) noexcept;
+    FrozenProfile(const FrozenProfile&) = delete;
+    FrozenProfile& operator=(const FrozenProfile&) = delete;
+
+    // Builds the snapshot from profiles given in ascending processName order
+    explicit FrozenProfile(const std::vector<UserActionProfile>& sorted);
+
+    // Builds the snapshot straight from a binary fingerprint (fingerprint_file.h):
+    // one mmap, the string pool is copied whole, no per-record allocation
+    bool loadBinary(const std::string& filename);
+
+    // DETECTION: nullptr if the process was never seen in training
+    const DurationStats* find(std::string_view processName) const;
+    bool search(std::string_view processName, UserActionProfile& outProfile) const;
+
+    size_t size() const { return n; }
+};
+
+#endif
@@ -2,8 +2,9 @@
 #define GRAPH_TRANSITION_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
+#include <map>
 #include <unordered_set>
 #include <iostream>
 #include <queue>
@@ -28,14 +29,15 @@ using namespace std;
 class GraphTransition {
 private:
     // Adjacency list: State -> List of next possible States
-    unordered_map<string, vector<string>> adjList;
+    // less<> makes lookups by string_view possible without building a string
+    map<string, vector<string>, less<>> adjList;
 
 public:
     GraphTransition();
     
     // Core Graph Operations
     void addTransition(const string& fromState, const string& toState);
-    bool isValidTransition(const string& fromState, const string& toState);
+    bool isValidTransition(string_view fromState, string_view toState) const;
     
     // Traversal Algorithms (New Implementation)
     void bfs(const string& startNode); // Breadth-First Search
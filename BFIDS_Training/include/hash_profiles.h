@@ -2,6 +2,10 @@
 #define HASH_PROFILES_H
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
 #include <iostream>
 #include "avl_profile.h"
 
@@ -10,45 +14,85 @@ using namespace std;
 /*
  * hashTable
  * ---------
- * Manages a hash table of user profiles for fast retrieval.
+ * Registry of user profiles: User ID -> AVLProfile*.
  * Provides:
- * - addProfile(): links a User ID to an AVLProfile
+ * - addProfile(): links a User ID to an AVLProfile; an ID that is already
+ *   registered has its pointer replaced in place
  * - getProfile(): retrieves the AVLProfile for a User ID
+ * - stats(): load factor and probe lengths
  * - displayTable(): shows the contents of the hash table
  *
- * Node stores:
- * hashNode { userId, profilePtr, next }
+ * Open addressing with Robin Hood probing: an entry being placed takes
+ * the slot of any entry that sits closer to its home slot, so probe
+ * lengths stay short and even, and a lookup can stop as soon as it
+ * passes an entry closer to home than itself.
+ *
+ * A slot is 8 bytes { entry index, 32-bit hash }; the IDs and pointers
+ * live in an append-only entries array, so probing touches one compact
+ * array and moving a slot never copies a string.
+ *
+ * Growth is incremental: past the maximum load a table twice the size
+ * is allocated and each following addProfile() moves a few slots of the
+ * old one, so no single insert pays for a full rehash. Lookups check the
+ * new table, then the part of the old one not moved yet.
  */
 
-class hashNode {
-public:
-    string userId;
-    AVLProfile* profilePtr;
-    hashNode* next;
+const double REGISTRY_MAX_LOAD = 0.85;
+const size_t REGISTRY_MIGRATE_STEP = 16;   // Old slots moved per addProfile() while growing
 
-    // Constructor: Takes a pointer to an AVLProfile
-    hashNode(const string& id, AVLProfile* ptr) 
-        : userId(id), profilePtr(ptr), next(nullptr) {}
+struct RegistryStats {
+    size_t size;
+    size_t capacity;        // Slots of the current (new) table
+    double loadFactor;
+    double avgProbe;        // Mean slots inspected by a successful lookup
+    int maxProbe;
+    bool rehashing;         // An old table is still being drained
+
+    RegistryStats() : size(0), capacity(0), loadFactor(0.0), avgProbe(0.0), maxProbe(0), rehashing(false) {}
 };
 
 class hashTable {
 private:
-    hashNode** table;
-    int capacity;
-    
-    int hashFunction(const string& key) const;
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t entry;     // Index into entries, EMPTY if unused
+        uint32_t hash;
+    };
+
+    struct Entry {
+        string userId;
+        AVLProfile* profilePtr;
+    };
+
+    vector<Entry> entries;
+    vector<Slot> table;
+    vector<Slot> oldTable;      // Non-empty only while growing
+    size_t migrated;            // Old slots below this index are already moved
+
+    static uint32_t hashFunction(string_view key);
+    static size_t probeDistance(const vector<Slot>& slots, size_t pos, uint32_t hash);
+
+    static void place(vector<Slot>& slots, Slot s);
+    long find(const vector<Slot>& slots, string_view key, uint32_t hash) const;
+    void grow();
+    void migrate(size_t steps);
 
 public:
+    // size: number of users expected; the table grows past it as needed
     hashTable(int size = 20);
-    ~hashTable();
-    
-    // Add a profile pointer for a specific User ID
-    void addProfile(const string& userId, AVLProfile* profilePtr);
-    
-    // Retrieve the profile pointer
-    AVLProfile* getProfile(const string& userId);
+
+    // Add a profile pointer for a specific User ID; returns false if the
+    // ID was already registered (its pointer is replaced)
+    bool addProfile(const string& userId, AVLProfile* profilePtr);
+
+    // Retrieve the profile pointer (string_view: no temporary string per lookup)
+    AVLProfile* getProfile(string_view userId) const;
+
+    size_t size() const { return entries.size(); }
+    RegistryStats stats() const;
 
     void displayTable() const;
 };
 
-#endif
\ No newline at end of file
+#endif
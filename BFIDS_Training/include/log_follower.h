@@ -0,0 +1,70 @@
+#ifndef LOG_FOLLOWER_H
+#define LOG_FOLLOWER_H
+
+#include <string>
+#include <functional>
+#include <sys/types.h>
+#include "log_parser.h"
+using namespace std;
+
+/*
+ * LogFollower
+ * -----------
+ * "tail -F" for action logs (e.g. the ones written by FileIO::saveAction
+ * or ActionLogWriter).
+ * Provides:
+ * - open(): starts following a file, from its end or from the start
+ * - poll(): sleeps on inotify until the file changes, then parses every
+ *   complete line appended since the last call as one batch
+ *
+ * The follower keeps its own read offset and holds back a trailing partial
+ * line until its '\n' arrives. Rotation is handled both ways:
+ * - rename/recreate: the old file is drained, then the new one is read from 0
+ * - truncate in place (copytruncate): reading restarts at offset 0
+ *
+ * A line still unfinished after LOG_FOLLOWER_MAX_LINE bytes is counted as
+ * rejected and skipped up to its '\n', so a writer that never ends its
+ * line cannot grow the follower's memory without bound.
+ */
+
+const size_t LOG_FOLLOWER_MAX_LINE = 64 * 1024;   // Longest partial line held back
+
+class LogFollower {
+private:
+    string path;
+    int fd;             // Currently followed file
+    int inotifyFd;      // -1 if inotify is unavailable (falls back to timed polling)
+    int fileWatch;
+    int dirWatch;
+    off_t offset;       // Next byte to read from fd
+    ino_t inode;
+    string pending;     // Bytes of an unfinished last line
+    bool discarding;    // Skipping the rest of an over-long line
+
+    bool openFile(bool fromStart);
+    void flushPending(ParseStats& stats, const function<void(const ActionFields&)>& fn);
+    void drainEvents();
+    void consume(const char* data, size_t len, ParseStats& stats,
+                 const function<void(const ActionFields&)>& fn);
+    void readAppended(ParseStats& stats, const function<void(const ActionFields&)>& fn);
+    bool checkRotation(ParseStats& stats, const function<void(const ActionFields&)>& fn);
+
+public:
+    LogFollower();
+    ~LogFollower();
+
+    LogFollower(const LogFollower&) = delete;
+    LogFollower& operator=(const LogFollower&) = delete;
+
+    // Starts following filename. fromStart=false skips what is already there.
+    bool open(const string& filename, bool fromStart = false);
+    void close();
+
+    // Waits up to timeoutMs for changes, then hands every new complete line to fn.
+    // stats receives the counts for this batch only.
+    bool poll(int timeoutMs, ParseStats& stats, const function<void(const ActionFields&)>& fn);
+
+    off_t getOffset() const { return offset; }
+};
+
+#endif
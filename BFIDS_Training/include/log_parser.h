@@ -0,0 +1,95 @@
+#ifndef LOG_PARSER_H
+#define LOG_PARSER_H
+
+#include <string>
+#include <string_view>
+#include <ctime>
+#include <cstddef>
+#include <functional>
+#include "user_action.h"
+using namespace std;
+
+/*
+ * LogParser
+ * ---------
+ * Zero-copy tokenizer for raw action logs.
+ * Provides:
+ * - MappedFile: read-only mmap of a whole log file (RAII)
+ * - parseLine(): splits one line into string_view fields
+ * - parseBuffer(): walks a byte range line by line and reports counts
+ * - parseStream(): same, but read()s the file through a fixed-size buffer
+ *
+ * Accepted line formats:
+ * - Labelled   : UserID: U101, Action: Login, Process: x, Duration: 1.5, Timestamp: 170..., NextAction: y, Status: Normal
+ * - Whitespace : U101 Login x 1.5 170... y Normal
+ * - Table row  : 2025-10-06 22:45:31  U101  Login  x  1.50  y  Normal  (saveActionsToFile)
+ *
+ * Fields point straight into the source buffer, so they are only valid
+ * while the MappedFile (or, for parseStream, the callback) is alive.
+ */
+
+// One parsed log line. Text fields are views into the source buffer.
+struct ActionFields {
+    string_view userID;
+    string_view action;
+    string_view processName;
+    double duration;
+    time_t timestamp;
+    string_view nextAction;
+    string_view status;
+
+    ActionFields() : duration(0.0), timestamp(0) {}
+
+    // Materializes the views into an owning UserAction
+    UserAction toUserAction() const;
+};
+
+// Line counters reported by parseBuffer() / FileIO::loadActionsFromFile()
+struct ParseStats {
+    size_t parsed;    // Lines turned into actions
+    size_t rejected;  // Non-empty lines that matched neither format
+
+    ParseStats() : parsed(0), rejected(0) {}
+};
+
+// Read-only memory mapping of an entire file
+class MappedFile {
+private:
+    const char* base;
+    size_t length;
+
+public:
+    MappedFile() : base(nullptr), length(0) {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& filename);
+    void close();
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+class LogParser {
+public:
+    // Parses a single line (without its '\n'). Returns false if it matches no format.
+    static bool parseLine(string_view line, ActionFields& out);
+
+    // Parses every line in [begin, end) and hands each valid one to fn
+    static ParseStats parseBuffer(const char* begin, const char* end,
+                                  const function<void(const ActionFields&)>& fn);
+
+    // Streams a file through a bufferBytes window; memory stays bounded regardless of file size
+    static bool parseStream(const string& filename, ParseStats& stats,
+                            const function<void(const ActionFields&)>& fn,
+                            size_t bufferBytes = 1 << 20);
+
+private:
+    static bool parseLabelled(string_view line, ActionFields& out);
+    static bool parseWhitespace(string_view line, ActionFields& out);
+    static bool parseTableRow(string_view line, ActionFields& out);
+};
+
+#endif
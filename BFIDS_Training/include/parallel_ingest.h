@@ -0,0 +1,34 @@
+#ifndef PARALLEL_INGEST_H
+#define PARALLEL_INGEST_H
+
+#include <string>
+#include <cstddef>
+#include "avl_profile.h"
+#include "log_parser.h"
+#include "process_totals.h"
+using namespace std;
+
+/*
+ * ParallelIngest
+ * --------------
+ * Multi-threaded training path for text action logs.
+ * Provides:
+ * - buildProfile(): maps the log, splits it on line boundaries into one
+ *   chunk per worker, aggregates each chunk into thread-local
+ *   ProcessTotals and merges them into the result.
+ *
+ * Only per-process sums are produced, and they merge exactly, so no
+ * sorting or LinkedList materialization is needed, and the profile is
+ * bit-identical to the sequential path for any number of threads.
+ */
+class ParallelIngest {
+public:
+    // Aggregates the whole log into out. Returns false if the file can't be read.
+    static bool buildProfile(const string& filename, int threads, AVLProfile& out, ParseStats& stats);
+
+private:
+    // Splits [0, size) into up to parts ranges that start right after a '\n'
+    static size_t splitOnLines(const char* data, size_t size, int parts, size_t* bounds);
+};
+
+#endif
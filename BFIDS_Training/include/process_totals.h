@@ -0,0 +1,46 @@
+#ifndef PROCESS_TOTALS_H
+#define PROCESS_TOTALS_H
+
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include "symbol_table.h"
+#include "duration_stats.h"
+#include "avl_profile.h"
+using namespace std;
+
+/*
+ * ProcessTotals
+ * -------------
+ * Per-process DurationSum accumulators keyed by interned name; the
+ * aggregation every train_system path (streaming, --threads, --report)
+ * goes through.
+ * Provides:
+ * - add(): one sample
+ * - merge(): folds another set of totals in (e.g. a worker's chunk)
+ * - exportTo(): writes one finished DurationStats per process into a profile
+ *
+ * The sums are exact, so the exported profile is bit-identical however
+ * the log was chunked, ordered or split across threads.
+ */
+class ProcessTotals {
+private:
+    SymbolTable names;
+    vector<DurationSum> sums;   // sums[id] belongs to names.lookup(id)
+
+    DurationSum& at(string_view processName);
+
+public:
+    ProcessTotals() {}
+
+    ProcessTotals(const ProcessTotals&) = delete;
+    ProcessTotals& operator=(const ProcessTotals&) = delete;
+
+    void add(string_view processName, double duration) { at(processName).add(duration); }
+    void merge(const ProcessTotals& other);
+
+    // Merges every process into out (mean and M2 computed here, once)
+    void exportTo(AVLProfile& out) const;
+};
+
+#endif
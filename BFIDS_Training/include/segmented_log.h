@@ -0,0 +1,133 @@
+#ifndef SEGMENTED_LOG_H
+#define SEGMENTED_LOG_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "user_action.h"
+#include "log_parser.h"
+#include "linked_list.h"
+using namespace std;
+
+/*
+ * SegmentedLog
+ * ------------
+ * Time-partitioned action log stored as a directory of segments.
+ * Provides:
+ * - SegmentedLogWriter: appends actions, rolling to a new segment when the
+ *   current one spans too much time or grows too large
+ * - SegmentedLogReader: answers "every event in [t1, t2)" by opening only
+ *   the segments, and the byte ranges inside them, that can contain it
+ *
+ * Directory layout:
+ *   MANIFEST           : one line per sealed segment
+ *                        "<name> <minTs> <maxTs> <records> <bytes>"
+ *   seg_<ts>_<n>.log   : action lines in the FileIO::saveAction format
+ *   seg_<ts>_<n>.idx   : sparse index, one entry per SEGMENT_INDEX_STRIDE records
+ *                        "BFSX" | u32 version | { u64 offset, i64 minTs, i64 maxTs }...
+ *
+ * Index entries keep the min and max timestamp of their stride, so events
+ * that arrive slightly out of order are still found. Segments are plain
+ * text logs, so every existing tool (LogParser, log_convert) can read them.
+ */
+
+const uint32_t SEGMENT_INDEX_VERSION = 1;
+const size_t SEGMENT_INDEX_STRIDE = 256;              // Records per sparse index entry
+const time_t SEGMENT_DEFAULT_SPAN = 24 * 60 * 60;     // Roll after one day of events
+const size_t SEGMENT_DEFAULT_BYTES = 64u << 20;       // ... or after 64 MB
+
+// Sparse index entry: byte range start of a stride and its time bounds
+struct SegmentIndexEntry {
+    uint64_t offset;
+    int64_t minTs;
+    int64_t maxTs;
+};
+
+// Manifest line for one sealed segment
+struct SegmentInfo {
+    string name;        // File name without extension, relative to the directory
+    time_t minTs;
+    time_t maxTs;
+    uint64_t records;
+    uint64_t bytes;
+
+    SegmentInfo() : minTs(0), maxTs(0), records(0), bytes(0) {}
+
+    // Can this segment hold events in [t1, t2)?
+    bool overlaps(time_t t1, time_t t2) const { return records > 0 && minTs < t2 && maxTs >= t1; }
+};
+
+class SegmentedLogWriter {
+private:
+    string dir;
+    time_t maxSpan;
+    size_t maxBytes;
+    vector<SegmentInfo> manifest;
+
+    // Active segment
+    ofstream out;
+    SegmentInfo current;
+    time_t segmentStart;    // Timestamp of the first event, drives time-based rolling
+    vector<SegmentIndexEntry> index;
+    string buffer;
+    int sequence;
+
+    bool startSegment(time_t firstTs);
+    bool sealSegment();
+    bool writeBuffer();
+    bool writeManifest() const;
+
+public:
+    SegmentedLogWriter(time_t spanSeconds = SEGMENT_DEFAULT_SPAN,
+                       size_t segmentBytes = SEGMENT_DEFAULT_BYTES);
+    ~SegmentedLogWriter();
+
+    SegmentedLogWriter(const SegmentedLogWriter&) = delete;
+    SegmentedLogWriter& operator=(const SegmentedLogWriter&) = delete;
+
+    // Opens (creating if needed) a segment directory. Existing segments are kept
+    // and new events always go to a fresh segment.
+    bool open(const string& directory);
+    // Appends one action; rolls the segment by time span or size first if needed
+    bool append(const UserAction& action);
+    // Seals the active segment (index + manifest) and closes the store
+    bool close();
+
+    size_t segmentCount() const { return manifest.size() + (out.is_open() ? 1 : 0); }
+};
+
+// Per-query counters, to see how much of the store a lookup had to touch
+struct SegmentQueryStats {
+    size_t segmentsTotal;
+    size_t segmentsRead;
+    uint64_t bytesRead;
+    size_t matched;
+
+    SegmentQueryStats() : segmentsTotal(0), segmentsRead(0), bytesRead(0), matched(0) {}
+};
+
+class SegmentedLogReader {
+private:
+    string dir;
+    vector<SegmentInfo> manifest;
+
+    bool loadIndex(const SegmentInfo& seg, vector<SegmentIndexEntry>& index) const;
+
+public:
+    // Reads the manifest of a segment directory
+    bool open(const string& directory);
+
+    const vector<SegmentInfo>& segments() const { return manifest; }
+
+    // Hands every event with t1 <= timestamp < t2 to fn (in log order within a segment)
+    bool query(time_t t1, time_t t2, const function<void(const ActionFields&)>& fn,
+               SegmentQueryStats* stats = nullptr) const;
+    // Same, appending the events to a list; returns how many were added
+    size_t query(time_t t1, time_t t2, LinkedList& list, SegmentQueryStats* stats = nullptr) const;
+};
+
+#endif
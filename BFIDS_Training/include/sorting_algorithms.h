@@ -2,6 +2,8 @@
 #define A88BAFA1_AB72_4A2D_812B_D477C32DA685
 
 #include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include "user_action.h"
 
 /*
@@ -12,6 +14,7 @@
  * - mergeSort(): O(n log n) divide and conquer sort
  * - quickSort(): O(n log n) average case partition sort
  * - heapSort(): O(n log n) heap-based sort
+ * - radixArgsort(): O(n) stable LSD radix sort of a timestamp column (returns a permutation)
  */
 
 class SortingAlgorithms {
@@ -20,6 +23,9 @@ public:
     static void mergeSort(UserAction arr[], size_t left, size_t right);
     static void quickSort(UserAction arr[], size_t low, size_t high);
     static void heapSort(UserAction arr[], size_t n);
+
+    // Column form (see event_table.h): fills perm[0..n) with row indices in ascending key order
+    static void radixArgsort(const time_t keys[], uint32_t perm[], size_t n);
 private:
     static void merge(UserAction arr[], size_t left, size_t mid, size_t right);
     static size_t partition(UserAction arr[], size_t low, size_t high);
@@ -0,0 +1,76 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+#include <ctime>
+#include "user_action.h"
+#include "log_parser.h"
+using namespace std;
+
+/*
+ * SymbolTable
+ * -----------
+ * String interning for the small, highly repetitive vocabulary of logs
+ * (user IDs, action names, process names, statuses).
+ * Provides:
+ * - intern(): returns the 32-bit id of a string, adding it if new
+ * - lookup(): returns the text of an id
+ * - encode()/decode(): UserAction <-> CompactAction
+ *
+ * Interned strings are stored once and never move, so lookups hand out
+ * stable references and intern() on a known string never allocates.
+ */
+
+typedef uint32_t SymbolID;
+
+/*
+ * CompactAction
+ * -------------
+ * Interned counterpart of UserAction: the five text fields become SymbolIDs.
+ * 40 bytes instead of sizeof(UserAction) (176 with libstdc++) plus any
+ * heap-allocated string bodies.
+ */
+struct CompactAction {
+    double duration;      // Action duration
+    time_t timestamp;     // Action time
+    SymbolID userID;
+    SymbolID action;
+    SymbolID processName;
+    SymbolID nextAction;
+    SymbolID status;
+
+    CompactAction()
+        : duration(0.0), timestamp(0), userID(0), action(0),
+          processName(0), nextAction(0), status(0) {}
+};
+
+class SymbolTable {
+private:
+    deque<string> strings;                        // id -> text (stable addresses)
+    unordered_map<string_view, SymbolID> index;   // text -> id (views into 'strings')
+
+public:
+    SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    SymbolID intern(string_view s);
+    // Returns false if s was never interned (does not add it)
+    bool find(string_view s, SymbolID& out) const;
+    const string& lookup(SymbolID id) const { return strings[id]; }
+    size_t size() const { return strings.size(); }
+
+    CompactAction encode(const UserAction& action);
+    CompactAction encode(const ActionFields& fields);
+    UserAction decode(const CompactAction& action) const;
+
+    // Approximate bytes held by the table itself
+    size_t memoryUsage() const;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include "action_log_writer.h"
+#include "file_io.h"
+
+#include <iostream>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+    action_log_writer.cpp
+    ---------------------
+    Group-commit writer for the text action log.
+    Instead of an open/write/close cycle per event (FileIO::saveAction),
+    records are formatted into an in-memory buffer and written in large
+    batches through one long-lived descriptor opened with O_APPEND.
+    The durability policy decides whether a batch is also synced to disk.
+*/
+
+ActionLogWriter::ActionLogWriter(size_t bufferBytes, int flushIntervalMs,
+                                 DurabilityPolicy durability, int syncIntervalMs)
+    : fd(-1),
+      bufferLimit(bufferBytes ? bufferBytes : 1),
+      flushInterval(flushIntervalMs),
+      syncInterval(syncIntervalMs),
+      policy(durability),
+      dirtySinceSync(false),
+      midLine(false) {
+    buffer.reserve(bufferLimit + 512);
+}
+
+ActionLogWriter::~ActionLogWriter() {
+    close();
+}
+
+/*
+    open
+    ----
+    Opens the log for appending, creating it if it does not exist.
+*/
+bool ActionLogWriter::open(const string& filename) {
+    close();
+
+    fd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) {
+        cerr << "Error: Could not open file '" << filename << "' for appending.\n";
+        return false;
+    }
+
+    stats = ActionLogWriterStats();
+    openedAt = lastFlush = lastSync = Clock::now();
+    dirtySinceSync = false;
+    midLine = false;
+    return true;
+}
+
+/*
+    writeAll
+    --------
+    Loops until the whole range is written (handles short writes and EINTR).
+    written receives how many bytes made it, also on failure.
+*/
+bool ActionLogWriter::writeAll(const char* data, size_t len, size_t& written) {
+    written = 0;
+    while (written < len) {
+        ssize_t n = ::write(fd, data + written, len - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += (size_t)n;
+        stats.bytesWritten += (uint64_t)n;
+    }
+    return true;
+}
+
+/*
+    sync
+    ----
+    Applies the durability policy after a batch has been written.
+    force=true syncs regardless of the interval (used on close).
+    A failed sync leaves the log dirty, so the next flush syncs again.
+*/
+bool ActionLogWriter::sync(bool force) {
+    if (policy == DurabilityPolicy::NoSync || !dirtySinceSync) return true;
+
+    Clock::time_point now = Clock::now();
+    int rc = 0;
+
+    if (policy == DurabilityPolicy::FsyncPerBatch) {
+        rc = ::fsync(fd);
+    } else {
+        if (!force && now - lastSync < syncInterval) return true;
+        rc = ::fdatasync(fd);
+    }
+
+    stats.syncs++;
+    if (rc != 0) return false;
+    lastSync = now;
+    dirtySinceSync = false;
+    return true;
+}
+
+/*
+    append
+    ------
+    Formats the action into the buffer.
+    Flushes once the buffer is full or the flush interval has passed.
+*/
+bool ActionLogWriter::append(const UserAction& action) {
+    if (fd < 0) return false;
+
+    FileIO::appendActionLine(action, buffer);
+    stats.records++;
+
+    if (buffer.size() >= bufferLimit) return flush();
+    return flushIfDue();
+}
+
+bool ActionLogWriter::flushIfDue() {
+    if (fd < 0) return false;
+    if (Clock::now() - lastFlush < flushInterval) return true;
+    return flush();
+}
+
+/*
+    flush
+    -----
+    Writes the buffered batch with a single write() and records its latency.
+    Whatever a failed write left unwritten stays in the buffer for the next
+    flush (the log is opened O_APPEND, so a half-written line is completed
+    by the retry). A backlog past ACTION_LOG_MAX_BACKLOG buffers is dropped.
+*/
+bool ActionLogWriter::flush() {
+    if (fd < 0) return false;
+
+    Clock::time_point start = Clock::now();
+    lastFlush = start;
+    if (buffer.empty()) return sync(false);
+
+    size_t written = 0;
+    bool ok = writeAll(buffer.data(), buffer.size(), written);
+    if (written > 0) {
+        midLine = buffer[written - 1] != '\n';
+        dirtySinceSync = true;
+    }
+    buffer.erase(0, written);
+    ok = sync(false) && ok;
+
+    double micros = chrono::duration<double, micro>(Clock::now() - start).count();
+    stats.flushes++;
+    stats.totalFlushMicros += micros;
+    if (micros > stats.maxFlushMicros) stats.maxFlushMicros = micros;
+
+    if (!ok) {
+        stats.failedFlushes++;
+        cerr << "Error: Failed to write action log batch (" << buffer.size() << " bytes kept for retry).\n";
+        if (buffer.size() > ACTION_LOG_MAX_BACKLOG * bufferLimit) dropBuffer(false);
+    }
+    return ok;
+}
+
+/*
+    dropBuffer
+    ----------
+    Gives up on the buffered bytes, counting them as lost. Only whole lines
+    are dropped: if a failed write left half a line in the log, the rest of
+    that line stays buffered (all=false) or, when everything must go (close),
+    a newline is written so the fragment does not swallow the next line.
+*/
+void ActionLogWriter::dropBuffer(bool all) {
+    size_t keep = 0;
+    if (midLine) {
+        if (!all) {
+            keep = buffer.find('\n');
+            keep = keep == string::npos ? buffer.size() : keep + 1;
+        } else {
+            size_t written = 0;
+            if (writeAll("\n", 1, written)) midLine = false;
+        }
+    }
+    if (buffer.size() <= keep) return;
+
+    size_t dropped = buffer.size() - keep;
+    cerr << "Error: Dropping " << dropped << " unwritten bytes of the action log.\n";
+    stats.bytesDropped += dropped;
+    buffer.erase(keep);
+}
+
+/*
+    close
+    -----
+    Writes what is left, forces a final sync (unless NoSync) and closes.
+*/
+bool ActionLogWriter::close() {
+    if (fd < 0) return true;
+
+    bool ok = flush();
+    ok = sync(true) && ok;
+    dropBuffer(true);
+    stats.elapsedSeconds = chrono::duration<double>(Clock::now() - openedAt).count();
+
+    ::close(fd);
+    fd = -1;
+    return ok;
+}
+
+/*
+    getStats
+    --------
+    Returns the counters; elapsed time is refreshed while the log is open.
+*/
+const ActionLogWriterStats& ActionLogWriter::getStats() const {
+    if (fd >= 0) stats.elapsedSeconds = chrono::duration<double>(Clock::now() - openedAt).count();
+    return stats;
+}
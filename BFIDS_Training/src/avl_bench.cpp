@@ -0,0 +1,296 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <atomic>
+
+#include "avl_profile.h"
+#include "frozen_profile.h"
+#include "concurrent_profile.h"
+#include "hash_profiles.h"
+#include "graph_transition.h"
+
+using namespace std;
+
+/*
+    avl_bench.cpp
+    -------------
+    Micro-benchmark for AVLProfile.
+    Inserts N distinct process names in random order, looks each one up
+    again (shuffled), repeats the lookups on the frozen snapshot used by
+    the monitors, then measures how long destroying the tree takes.
+    Finally it counts heap allocations made by steady-state lookups through
+    the string_view APIs (profile, registry, state graph); expected: 0.
+    The concurrent section publishes batches of 10k updates to a
+    ConcurrentProfile while a reader thread keeps looking keys up; the
+    stress section then has several readers check every snapshot they
+    take while the writer publishes one new key per version, as fast as
+    it can (build with -fsanitize=address to catch early frees).
+    The registry section adds N user IDs to a hashTable that starts at
+    its default size (growing incrementally), re-registers them all
+    (update in place), looks them up and prints load and probe lengths.
+
+    Usage: ./avl_bench [N]   (default 1000000)
+*/
+
+typedef chrono::steady_clock Clock;
+
+// Every operator new in the process bumps this counter. The concurrent
+// sections allocate from several threads, hence atomic (relaxed: only
+// the total is read, after the threads are joined or idle).
+static atomic<size_t> heapAllocations(0);
+
+static void* countedAlloc(size_t size) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+// Every plain, array and sized form is replaced, so each pointer is freed
+// by the allocator that made it (with new[] left to the library, its
+// pointers reached this free() and -Wmismatched-new-delete fired).
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+/*
+    countLookupAllocations
+    ----------------------
+    Warms every lookup path once, then repeats it and returns how many
+    allocations the repeated (steady-state) lookups made.
+*/
+static size_t countLookupAllocations(const AVLProfile& profile, const vector<string>& keys) {
+    hashTable registry(10);
+    AVLProfile* userProfile = const_cast<AVLProfile*>(&profile);
+    registry.addProfile("ali", userProfile);
+
+    GraphTransition states;
+    states.addTransition("Safe", "Warning");
+    states.addTransition("Warning", "Anomaly");
+
+    // A parsed log slice: the key is a view into a larger buffer
+    string line = "Process: " + keys[0] + ", Duration: 1.5";
+    string_view slice(line.data() + 9, keys[0].size());
+
+    UserActionProfile out;
+    int frequency = 0;
+    double avg = 0.0;
+    size_t hits = 0;
+
+    auto lookups = [&]() {
+        hits += profile.search(slice, out);
+        hits += profile.search("Keystroke_Dynamics", frequency, avg);
+        hits += profile.search(slice, frequency, avg);
+        hits += registry.getProfile("ali") != nullptr;
+        hits += registry.getProfile(string_view("ali")) != nullptr;
+        hits += states.isValidTransition("Safe", "Warning");
+        hits += states.isValidTransition("Lockdown", "Safe");
+    };
+
+    lookups();
+    size_t before = heapAllocations.load(memory_order_relaxed);
+    for (int i = 0; i < 1000; i++) lookups();
+    return heapAllocations.load(memory_order_relaxed) - before;
+}
+
+static double msSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+/*
+    benchConcurrent
+    ---------------
+    Publishes `batches` batches of 10k updates (random existing keys) while
+    one reader thread snapshots and looks up in a loop. Returns the median
+    publish time in ms; readerLookups / readerMisses report what the reader saw
+    (every key exists in every version, so misses must stay 0).
+*/
+static double benchConcurrent(const AVLProfile& profile, const vector<string>& keys, int batches,
+                              size_t& readerLookups, size_t& readerMisses) {
+    const size_t BATCH = 10000;
+    ConcurrentProfile live;
+    live.loadFrom(profile);
+
+    atomic<bool> stop(false);
+    readerLookups = readerMisses = 0;
+    thread reader([&]() {
+        size_t i = 0, lookups = 0, misses = 0;
+        while (!stop.load(memory_order_relaxed)) {
+            ConcurrentProfile::Snapshot snap = live.snapshot();
+            for (int k = 0; k < 64; k++, i++) misses += snap.find(keys[i % keys.size()]) == nullptr;
+            lookups += 64;
+        }
+        readerLookups = lookups;
+        readerMisses = misses;
+    });
+
+    mt19937_64 rng(7);
+    vector<double> publishMs;
+    for (int b = 0; b < batches; b++) {
+        for (size_t i = 0; i < BATCH; i++) live.insertOrUpdate(keys[rng() % keys.size()], (double)(i % 100));
+        Clock::time_point t = Clock::now();
+        live.publish();
+        publishMs.push_back(msSince(t));
+    }
+
+    stop = true;
+    reader.join();
+    sort(publishMs.begin(), publishMs.end());
+    return publishMs[publishMs.size() / 2];
+}
+
+/*
+    stressConcurrent
+    ----------------
+    Version v holds exactly the keys stress_0 .. stress_{v-1}, so a reader
+    can check any snapshot from its size alone: the last key must be
+    there and the next one must not. Returns the number of snapshots
+    that failed the check; `snapshots` reports how many were taken.
+*/
+static size_t stressConcurrent(int readerCount, size_t publishes, size_t& snapshots) {
+    vector<string> names;
+    names.reserve(publishes + 1);
+    for (size_t i = 0; i <= publishes; i++) names.push_back("stress_" + to_string(i));
+
+    ConcurrentProfile live;
+    atomic<bool> stop(false);
+    atomic<size_t> taken(0), errors(0);
+    vector<thread> readers;
+    for (int r = 0; r < readerCount; r++) {
+        readers.emplace_back([&]() {
+            size_t local = 0, bad = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                ConcurrentProfile::Snapshot snap = live.snapshot();
+                size_t s = snap.size();
+                if ((s > 0 && snap.find(names[s - 1]) == nullptr) || snap.find(names[s]) != nullptr) bad++;
+                local++;
+            }
+            taken += local;
+            errors += bad;
+        });
+    }
+
+    for (size_t v = 0; v < publishes; v++) {
+        live.insertOrUpdate(names[v], 1.0);
+        live.publish();
+    }
+    stop = true;
+    for (thread& t : readers) t.join();
+
+    snapshots = taken;
+    return errors;
+}
+
+/*
+    benchRegistry
+    -------------
+    Registers n user IDs pointing at one profile, registers them again (every
+    call must update in place), then looks each one up plus n absent IDs.
+    Returns false if any result is wrong.
+*/
+static bool benchRegistry(size_t n, mt19937_64& rng) {
+    vector<string> users;
+    users.reserve(n);
+    for (size_t i = 0; i < n; i++) users.push_back("user_" + to_string(i * 2654435761u % 1000000007u));
+    shuffle(users.begin(), users.end(), rng);
+
+    hashTable registry;
+    AVLProfile first, second;
+
+    Clock::time_point t = Clock::now();
+    size_t added = 0;
+    for (size_t i = 0; i < n; i++) added += registry.addProfile(users[i], &first);
+    double addMs = msSince(t);
+    RegistryStats grown = registry.stats();
+
+    t = Clock::now();
+    size_t updated = 0;
+    for (size_t i = 0; i < n; i++) updated += !registry.addProfile(users[i], &second);
+    double updateMs = msSince(t);
+
+    shuffle(users.begin(), users.end(), rng);
+    size_t hits = 0, misses = 0;
+    t = Clock::now();
+    for (size_t i = 0; i < n; i++) hits += registry.getProfile(users[i]) == &second;
+    double lookupMs = msSince(t);
+    for (size_t i = 0; i < n; i++) misses += registry.getProfile("absent_" + to_string(i)) == nullptr;
+
+    RegistryStats s = registry.stats();
+    cout << "registry add   : " << addMs * 1e6 / n << " ns/op (load " << grown.loadFactor
+         << (grown.rehashing ? ", mid-resize" : "") << ")\n"
+         << "registry update: " << updateMs * 1e6 / n << " ns/op\n"
+         << "registry lookup: " << lookupMs * 1e6 / n << " ns/op\n"
+         << "registry: " << s.size << " users, " << s.capacity << " slots, load " << s.loadFactor
+         << ", probe avg " << s.avgProbe << " max " << s.maxProbe << "\n";
+    return added == n && updated == n && hits == n && misses == n && registry.size() == n;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = (argc > 1) ? (size_t)atoll(argv[1]) : 1000000;
+
+    vector<string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; i++) keys.push_back("proc_" + to_string(i * 2654435761u % 1000000007u));
+
+    mt19937_64 rng(42);
+    shuffle(keys.begin(), keys.end(), rng);
+
+    AVLProfile* profile = new AVLProfile();
+
+    Clock::time_point t = Clock::now();
+    for (size_t i = 0; i < n; i++) profile->insertOrUpdate(keys[i], (double)(i % 100));
+    double insertMs = msSince(t);
+
+    shuffle(keys.begin(), keys.end(), rng);
+    UserActionProfile out;
+    size_t found = 0;
+    t = Clock::now();
+    for (size_t i = 0; i < n; i++) found += profile->search(keys[i], out);
+    double lookupMs = msSince(t);
+
+    t = Clock::now();
+    FrozenProfile frozen = profile->freeze();
+    double freezeMs = msSince(t);
+
+    size_t frozenFound = 0;
+    t = Clock::now();
+    for (size_t i = 0; i < n; i++) frozenFound += frozen.find(keys[i]) != nullptr;
+    double frozenMs = msSince(t);
+
+    size_t lookupAllocs = countLookupAllocations(*profile, keys);
+
+    size_t readerLookups = 0, readerMisses = 0;
+    double publishMs = benchConcurrent(*profile, keys, 20, readerLookups, readerMisses);
+
+    size_t stressSnapshots = 0;
+    size_t stressErrors = stressConcurrent(4, 20000, stressSnapshots);
+
+    t = Clock::now();
+    delete profile;
+    double destroyMs = msSince(t);
+
+    cout << "keys=" << n << " found=" << found << "\n"
+         << "insert : " << insertMs << " ms (" << insertMs * 1e6 / n << " ns/op)\n"
+         << "lookup : " << lookupMs << " ms (" << lookupMs * 1e6 / n << " ns/op)\n"
+         << "freeze : " << freezeMs << " ms\n"
+         << "frozen lookup: " << frozenMs << " ms (" << frozenMs * 1e6 / n << " ns/op)\n"
+         << "destroy: " << destroyMs << " ms\n"
+         << "steady-state lookup allocations: " << lookupAllocs << "\n"
+         << "concurrent publish (10k updates, median of 20): " << publishMs << " ms, reader lookups="
+         << readerLookups << " misses=" << readerMisses << "\n"
+         << "concurrent stress (4 readers, 20000 single-key publishes): " << stressSnapshots
+         << " snapshots, errors=" << stressErrors << "\n";
+    bool registryOk = benchRegistry(n, rng);
+    return (found == n && frozenFound == n && lookupAllocs == 0 && readerMisses == 0 && stressErrors == 0 && registryOk) ? 0 : 1;
+}
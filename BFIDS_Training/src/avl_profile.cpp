@@ -5,7 +5,14 @@
 #include <iostream>
 #include <sstream>
 #include <functional>
+#include <memory>
 #include "../include/btree_index.h"
+#include "../include/disk_btree.h"
+#include "../include/frozen_profile.h"
+#include "../include/fingerprint_file.h"
+#include <cstring>
+#include <cstdio>
+#include <sys/stat.h>
 using namespace std;
 
 /*
@@ -20,49 +27,186 @@ using namespace std;
     DSA Concepts:
         - Binary Search Tree (BST) operations
         - AVL Rotations (LL, RR, LR, RL)
-        - Recursion (Insert, Search, Traversal)
+        - Iterative Insert / Search / Traversal over an index-linked node pool
 */
 
-// Helper to save B-Tree index (Disk optimization simulation)
-void saveBTreeIndexToDisk(BTreeIndex* index, const std::string& indexFilename) {
-    std::cout << "[B-Tree Utility] Saving index to " << indexFilename << "..." << std::endl;
+// Identity of a CSV file for the index tag: device, inode, size and
+// modification time (ns) folded into 64 bits (FNV-1a). Any rewrite of
+// the file, even to the same length, changes the mtime and so the stamp.
+static bool csvStamp(const std::string& filename, uint64_t& out) {
+    struct stat st;
+    if (::stat(filename.c_str(), &st) != 0) return false;
+    uint64_t fields[5] = { (uint64_t)st.st_dev, (uint64_t)st.st_ino, (uint64_t)st.st_size,
+                           (uint64_t)st.st_mtim.tv_sec, (uint64_t)st.st_mtim.tv_nsec };
+    uint64_t h = 1469598103934665603ull;
+    for (uint64_t f : fields) {
+        for (int i = 0; i < 8; i++) {
+            h ^= (f >> (8 * i)) & 0xFF;
+            h *= 1099511628211ull;
+        }
+    }
+    out = h;
+    return true;
+}
+
+// Helper to save B-Tree index: bulk-loads the paged file (disk_btree.h)
+// straight from the (name, row offset) pairs, already in key order.
+// tag records which CSV the offsets belong to (csvStamp); it is only
+// stamped on a complete index. On failure the file is removed, so a
+// partial (or older) index can never be taken for this CSV's.
+static bool saveBTreeIndexToDisk(const std::vector<IndexEntry>& sorted, const std::string& indexFilename, uint64_t tag) {
+    DiskBTree disk;
+    bool ok = disk.create(indexFilename);
+    if (!ok) {
+        std::cerr << "Error: Could not create index '" << indexFilename << "'." << std::endl;
+        std::remove(indexFilename.c_str());
+        return false;
+    }
+    ok = disk.bulkLoad(sorted);
+    if (ok) disk.setTag(tag);
+    ok = disk.close() && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed to write index '" << indexFilename << "'." << std::endl;
+        std::remove(indexFilename.c_str());
+    }
+    return ok;
 }
 
-// Helper to load B-Tree index
-BTreeIndex* loadBTreeIndexFromDisk(const std::string& indexFilename) {
-    std::cout << "[B-Tree Utility] Loading index from " << indexFilename << "..." << std::endl;
-    return new BTreeIndex();
+// Helper to load B-Tree index: opens the paged file read-only, nullptr if absent
+static DiskBTree* loadBTreeIndexFromDisk(const std::string& indexFilename) {
+    DiskBTree* disk = new DiskBTree();
+    if (!disk->open(indexFilename)) {
+        delete disk;
+        return nullptr;
+    }
+    return disk;
+}
+
+/*
+    parseCSVRow
+    -----------
+    One data row of a fingerprint CSV. Old three-column rows leave the
+    extended fields at their defaults.
+*/
+static bool parseCSVRow(const string& line, UserActionProfile& p) {
+    string name;
+    int freq;
+    double avg;
+
+    stringstream ss(line);
+    getline(ss, name, ',');
+    if (!(ss >> freq)) return false;
+    ss.ignore(1, ',');
+    if (!(ss >> avg)) return false;
+
+    p = UserActionProfile(name, freq, avg);
+
+    // Extended columns: StdDev,Min,Max,P50,P99,Buckets
+    double sd, mn, mx, p50, p99;
+    char c;
+    if (ss >> c >> sd >> c >> mn >> c >> mx >> c >> p50 >> c >> p99 >> c) {
+        p.m2 = sd * sd * freq;
+        p.minDuration = mn;
+        p.maxDuration = mx;
+        fill(p.buckets, p.buckets + DURATION_BUCKETS, 0u);
+
+        string bucketList;
+        getline(ss, bucketList);
+        stringstream bs(bucketList);
+        string pair;
+        while (getline(bs, pair, ';')) {
+            size_t colon = pair.find(':');
+            if (colon == string::npos) continue;
+            int b = atoi(pair.substr(0, colon).c_str());
+            if (b >= 0 && b < DURATION_BUCKETS) p.buckets[b] = (uint32_t)strtoul(pair.c_str() + colon + 1, nullptr, 10);
+        }
+    }
+    return true;
 }
 
 // Constructor
-AVLProfile::AVLProfile() : root(nullptr) {}
+AVLProfile::AVLProfile() : root(NIL) {}
 
 // Destructor
-AVLProfile::~AVLProfile() {
-    destroy(root);
+// Nodes hold no owned memory, so this just frees the pool and the arena.
+AVLProfile::~AVLProfile() {}
+
+/*
+    clear
+    -----
+    Releases both buffers at once; no per-node work is needed.
+*/
+void AVLProfile::clear() {
+    std::vector<Node>().swap(nodes);
+    std::vector<DurationStats>().swap(stats);
+    std::vector<char>().swap(keyArena);
+    root = NIL;
+}
+
+/*
+    Probe
+    -----
+    Packs the first 16 bytes of a key into two big-endian words, so
+    comparing words orders keys exactly like comparing the bytes.
+*/
+AVLProfile::Probe::Probe(string_view s) : name(s) {
+    for (int w = 0; w < 2; w++) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < 8; i++) {
+            size_t pos = w * 8 + i;
+            unsigned char c = pos < s.size() ? (unsigned char)s[pos] : 0;
+            v = (v << 8) | c;
+        }
+        prefix[w] = v;
+    }
+}
+
+/*
+    compare
+    -------
+    Orders probe against node n. Only keys sharing their first 16 bytes
+    fall through to the arena.
+*/
+int AVLProfile::compare(const Probe& probe, uint32_t n) const {
+    const Node& node = nodes[n];
+    if (probe.prefix[0] != node.prefix[0]) return probe.prefix[0] < node.prefix[0] ? -1 : 1;
+    if (probe.prefix[1] != node.prefix[1]) return probe.prefix[1] < node.prefix[1] ? -1 : 1;
+    return probe.name.compare(key(n));
 }
 
 /*
-    destroy
+    newNode
     -------
-    Recursively deletes all nodes in the tree.
-    Traverses in post-order (left, right, root) to safely free memory.
+    Copies the name into the arena and appends a leaf to the pool.
 */
-void AVLProfile::destroy(Node* node) {
-    if (!node) return;
-    destroy(node->left);
-    destroy(node->right);
-    delete node;
+uint32_t AVLProfile::newNode(const Probe& probe, const DurationStats& initial) {
+    string_view processName = probe.name;
+    Node n;
+    n.prefix[0] = probe.prefix[0];
+    n.prefix[1] = probe.prefix[1];
+    n.keyOffset = (uint32_t)keyArena.size();
+    n.keyLength = (uint32_t)processName.size();
+    n.left = n.right = NIL;
+    n.height = 1;
+
+    keyArena.insert(keyArena.end(), processName.begin(), processName.end());
+    nodes.push_back(n);
+    stats.push_back(initial);
+    return (uint32_t)(nodes.size() - 1);
+}
+
+UserActionProfile AVLProfile::toProfile(uint32_t n) const {
+    return UserActionProfile(string(key(n)), stats[n]);
 }
 
 /*
     height
     ------
     Returns the height of a given node.
-    Handles nullptr safely (height 0).
+    Handles NIL safely (height 0).
 */
-int AVLProfile::height(Node* n) const {
-    return n ? n->height : 0;
+int AVLProfile::height(uint32_t n) const {
+    return n == NIL ? 0 : nodes[n].height;
 }
 
 /*
@@ -71,9 +215,13 @@ int AVLProfile::height(Node* n) const {
     Calculates the balance factor of a node (left height - right height).
     Used to detect if a rotation is needed.
 */
-int AVLProfile::getBalance(Node* n) const {
-    if (!n) return 0;
-    return height(n->left) - height(n->right);
+int AVLProfile::getBalance(uint32_t n) const {
+    if (n == NIL) return 0;
+    return height(nodes[n].left) - height(nodes[n].right);
+}
+
+void AVLProfile::updateHeight(uint32_t n) {
+    nodes[n].height = 1 + max(height(nodes[n].left), height(nodes[n].right));
 }
 
 /*
@@ -82,15 +230,15 @@ int AVLProfile::getBalance(Node* n) const {
     Performs a Right Rotation on the subtree rooted at y.
     Used to fix Left-Left cases.
 */
-AVLProfile::Node* AVLProfile::rightRotate(Node* y) {
-    Node* x = y->left;
-    Node* t = x->right;
+uint32_t AVLProfile::rightRotate(uint32_t y) {
+    uint32_t x = nodes[y].left;
+    uint32_t t = nodes[x].right;
 
-    x->right = y;
-    y->left = t;
+    nodes[x].right = y;
+    nodes[y].left = t;
 
-    y->height = 1 + max(height(y->left), height(y->right));
-    x->height = 1 + max(height(x->left), height(x->right));
+    updateHeight(y);
+    updateHeight(x);
 
     return x;
 }
@@ -101,86 +249,171 @@ AVLProfile::Node* AVLProfile::rightRotate(Node* y) {
     Performs a Left Rotation on the subtree rooted at x.
     Used to fix Right-Right cases.
 */
-AVLProfile::Node* AVLProfile::leftRotate(Node* x) {
-    Node* y = x->right;
-    Node* t = y->left;
+uint32_t AVLProfile::leftRotate(uint32_t x) {
+    uint32_t y = nodes[x].right;
+    uint32_t t = nodes[y].left;
 
-    y->left = x;
-    x->right = t;
+    nodes[y].left = x;
+    nodes[x].right = t;
 
-    x->height = 1 + max(height(x->left), height(x->right));
-    y->height = 1 + max(height(y->left), height(y->right));
+    updateHeight(x);
+    updateHeight(y);
 
     return y;
 }
 
 /*
-    insertOrUpdate
-    --------------
-    Public interface for training data.
-    If the process exists, it updates the stats.
-    If not, it inserts a new node.
+    rebalance
+    ---------
+    Restores the AVL property at n after one insertion below it.
+    The child's balance picks between the single (LL/RR) and
+    double (LR/RL) rotation cases. Returns the new subtree root.
 */
-void AVLProfile::insertOrUpdate(const std::string& processName, double duration) {
-    root = insertOrUpdateNode(root, processName, duration);
+uint32_t AVLProfile::rebalance(uint32_t n) {
+    updateHeight(n);
+    int balance = getBalance(n);
+
+    if (balance > 1) {
+        // Left Right Case
+        if (getBalance(nodes[n].left) < 0) nodes[n].left = leftRotate(nodes[n].left);
+        // Left Left Case
+        return rightRotate(n);
+    }
+    if (balance < -1) {
+        // Right Left Case
+        if (getBalance(nodes[n].right) > 0) nodes[n].right = rightRotate(nodes[n].right);
+        // Right Right Case
+        return leftRotate(n);
+    }
+    return n;
 }
 
 /*
-    insertOrUpdateNode
-    ------------------
-    Recursive function to insert or update a node.
-    Calculates the new running average for duration if the node exists.
-    Performs AVL balancing after insertion.
+    findOrInsert
+    ------------
+    Iterative BST descent that remembers the path.
+    If the key is missing, a leaf with zeroed stats is linked in and the
+    path is walked back up, rebalancing and re-linking rotated subtrees.
+    Node ids never change, so the returned id stays valid.
 */
-AVLProfile::Node* AVLProfile::insertOrUpdateNode(Node* node, const string& processName, double duration) {
-
-    // Standard BST insert
-    if (!node) {
-        UserActionProfile p(processName, 1, duration);
-        return new Node(p);
+uint32_t AVLProfile::findOrInsert(string_view processName) {
+    // AVL height is < 1.45 log2(n + 2), so 64 levels cover any 32-bit pool
+    uint32_t path[64];
+    int depth = 0;
+    int cmp = 0;
+    Probe probe(processName);
+
+    uint32_t cur = root;
+    while (cur != NIL) {
+        cmp = compare(probe, cur);
+        if (cmp == 0) return cur;
+        path[depth++] = cur;
+        cur = cmp < 0 ? nodes[cur].left : nodes[cur].right;
     }
 
-    if (processName < node->profile.processName) {
-        node->left = insertOrUpdateNode(node->left, processName, duration);
+    uint32_t created = newNode(probe, DurationStats());
+    if (depth == 0) {
+        root = created;
+        return created;
     }
-    else if (processName > node->profile.processName) {
-        node->right = insertOrUpdateNode(node->right, processName, duration);
-    }
-    else {
-        // Update existing process stats (Moving Average Calculation)
-        double total = node->profile.avgDuration * node->profile.frequency + duration;
-        node->profile.frequency++;
-        node->profile.avgDuration = total / node->profile.frequency;
-        return node;
-    }
-
-    // Update height after insertion
-    node->height = 1 + max(height(node->left), height(node->right));
 
-    // Balance the tree
-    int balance = getBalance(node);
+    uint32_t parent = path[depth - 1];
+    if (cmp < 0) nodes[parent].left = created;
+    else nodes[parent].right = created;
+
+    for (int i = depth - 1; i >= 0; i--) {
+        uint32_t n = path[i];
+        int oldHeight = nodes[n].height;
+        uint32_t sub = rebalance(n);
+
+        if (sub != n) {
+            if (i == 0) root = sub;
+            else if (nodes[path[i - 1]].left == n) nodes[path[i - 1]].left = sub;
+            else nodes[path[i - 1]].right = sub;
+        }
+        // Height unchanged (or fixed by a rotation): ancestors are unaffected
+        if (sub != n || nodes[n].height == oldHeight) break;
+    }
+    return created;
+}
 
-    // Left Left Case
-    if (balance > 1 && processName < node->left->profile.processName)
-        return rightRotate(node);
+/*
+    insertOrUpdate
+    --------------
+    Public interface for training data.
+    If the process exists, it updates the stats (Moving Average Calculation).
+    If not, it inserts a new node.
+*/
+void AVLProfile::insertOrUpdate(string_view processName, double duration) {
+    stats[findOrInsert(processName)].add(duration);
+}
 
-    // Right Right Case
-    if (balance < -1 && processName > node->right->profile.processName)
-        return leftRotate(node);
+// 64-bit FNV-1a (batch pre-aggregation table)
+static uint64_t hashName(string_view s) {
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
 
-    // Left Right Case
-    if (balance > 1 && processName > node->left->profile.processName) {
-        node->left = leftRotate(node->left);
-        return rightRotate(node);
+/*
+    insertOrUpdateBatch
+    -------------------
+    1. Pre-aggregate: each sample is added (Welford, in input order) to
+       the summary of its name, found through a small open-addressing
+       table that is kept at most half full.
+    2. Apply: one findOrInsert + DurationStats::merge per distinct name,
+       in order of first appearance.
+    A new name ends up with exactly the sequential result; an existing
+    one gets the Chan merge of both summaries.
+*/
+void AVLProfile::insertOrUpdateBatch(const DurationSample* samples, size_t count) {
+    struct Group {
+        string_view name;
+        uint64_t hash;
+        DurationStats stats;
+    };
+    const uint32_t EMPTY = NIL;
+    vector<Group> groups;
+    vector<uint32_t> table(16, EMPTY);  // Slot -> index into groups
+
+    for (size_t i = 0; i < count; i++) {
+        string_view name = samples[i].first;
+        uint64_t h = hashName(name);
+        size_t mask = table.size() - 1;
+        size_t slot = h & mask;
+        while (table[slot] != EMPTY && (groups[table[slot]].hash != h || groups[table[slot]].name != name)) {
+            slot = (slot + 1) & mask;
+        }
+
+        uint32_t g = table[slot];
+        if (g == EMPTY) {
+            g = (uint32_t)groups.size();
+            groups.push_back({ name, h, DurationStats() });
+            table[slot] = g;
+
+            if (groups.size() * 2 > table.size()) {
+                table.assign(table.size() * 2, EMPTY);
+                mask = table.size() - 1;
+                for (uint32_t j = 0; j < groups.size(); j++) {
+                    size_t s = groups[j].hash & mask;
+                    while (table[s] != EMPTY) s = (s + 1) & mask;
+                    table[s] = j;
+                }
+            }
+        }
+        groups[g].stats.add(samples[i].second);
     }
 
-    // Right Left Case
-    if (balance < -1 && processName < node->right->profile.processName) {
-        node->right = rightRotate(node->right);
-        return leftRotate(node);
+    for (const Group& group : groups) {
+        stats[findOrInsert(group.name)].merge(group.stats);
     }
+}
 
-    return node;
+void AVLProfile::insertOrUpdateBatch(const vector<DurationSample>& samples) {
+    insertOrUpdateBatch(samples.data(), samples.size());
 }
 
 /*
@@ -190,61 +423,211 @@ AVLProfile::Node* AVLProfile::insertOrUpdateNode(Node* node, const string& proce
     Does not update averages; simply places the data into the tree.
 */
 void AVLProfile::insertProfileDirect(const UserActionProfile& profile) {
-    root = insertProfileNode(root, profile);
+    stats[findOrInsert(profile.processName)] = profile;
+}
+
+/*
+    linkBalanced
+    ------------
+    Nodes lo..hi-1 were appended in ascending key order, so the middle one
+    becomes the subtree root and each half is linked the same way.
+    Both halves differ in size by at most one, so the result is a valid
+    AVL tree without a single rotation. O(n) overall.
+*/
+uint32_t AVLProfile::linkBalanced(uint32_t lo, uint32_t hi) {
+    if (lo >= hi) return NIL;
+
+    uint32_t mid = lo + (hi - lo) / 2;
+    nodes[mid].left = linkBalanced(lo, mid);
+    nodes[mid].right = linkBalanced(mid + 1, hi);
+    updateHeight(mid);
+    return mid;
+}
+
+/*
+    bulkLoad
+    --------
+    1. Non-empty tree: nothing to build from scratch, insert one by one.
+    2. Check order in one pass; if unsorted (or duplicated), stable-sort
+       and keep the last of each name.
+    3. Append every profile to the pool and link them in O(n).
+*/
+void AVLProfile::bulkLoad(vector<UserActionProfile>& profiles) {
+    if (root != NIL) {
+        for (const UserActionProfile& p : profiles) insertProfileDirect(p);
+        return;
+    }
+
+    bool sorted = true;
+    for (size_t i = 1; i < profiles.size() && sorted; i++) {
+        sorted = profiles[i - 1].processName < profiles[i].processName;
+    }
+    if (!sorted) {
+        stable_sort(profiles.begin(), profiles.end(),
+                    [](const UserActionProfile& a, const UserActionProfile& b) {
+                        return a.processName < b.processName;
+                    });
+        size_t out = 0;
+        for (size_t i = 0; i < profiles.size(); i++) {
+            if (i + 1 < profiles.size() && profiles[i].processName == profiles[i + 1].processName) continue;
+            if (out != i) profiles[out] = move(profiles[i]);
+            out++;
+        }
+        profiles.resize(out);
+    }
+
+    size_t arenaBytes = 0;
+    for (const UserActionProfile& p : profiles) arenaBytes += p.processName.size();
+    nodes.reserve(profiles.size());
+    stats.reserve(profiles.size());
+    keyArena.reserve(arenaBytes);
+
+    for (const UserActionProfile& p : profiles) {
+        newNode(Probe(p.processName), p);
+    }
+    root = linkBalanced(0, (uint32_t)nodes.size());
+}
+
+/*
+    mergeProfile
+    ------------
+    Folds a partially aggregated profile into the tree.
+    Frequencies, min/max and sketch buckets add up; mean and M2 are
+    combined exactly (DurationStats::merge), so the result matches
+    inserting every sample here directly.
+*/
+void AVLProfile::mergeProfile(const UserActionProfile& profile) {
+    if (profile.frequency <= 0) return;
+
+    // A new node starts empty, and merging into an empty summary copies it
+    stats[findOrInsert(profile.processName)].merge(profile);
 }
 
 /*
-    insertProfileNode
-    -----------------
-    Recursive function to insert a pre-defined profile node.
-    Maintains AVL balance.
+    mergeFrom
+    ---------
+    Merges every entry of another profile (e.g. a worker thread's partial result).
 */
-AVLProfile::Node* AVLProfile::insertProfileNode(Node* node, const UserActionProfile& profile) {
-    if (!node) return new Node(profile);
+void AVLProfile::mergeFrom(const AVLProfile& other) {
+    other.forEach([this](const UserActionProfile& p) {
+        mergeProfile(p);
+    });
+}
 
-    if (profile.processName < node->profile.processName)
-        node->left = insertProfileNode(node->left, profile);
-    else if (profile.processName > node->profile.processName)
-        node->right = insertProfileNode(node->right, profile);
-    else {
-        node->profile = profile;
-        return node;
+/*
+    forEach
+    -------
+    Public in-order traversal (sorted by process name).
+    Uses an explicit stack instead of recursion.
+*/
+void AVLProfile::forEach(const function<void(const UserActionProfile&)>& fn) const {
+    uint32_t stack[64];
+    int top = 0;
+    uint32_t cur = root;
+
+    while (cur != NIL || top > 0) {
+        while (cur != NIL) {
+            stack[top++] = cur;
+            cur = nodes[cur].left;
+        }
+        cur = stack[--top];
+        fn(toProfile(cur));
+        cur = nodes[cur].right;
     }
+}
 
-    node->height = 1 + max(height(node->left), height(node->right));
+/*
+    Cursor
+    ------
+    Iterative in-order walk: the stack holds the current node and every
+    ancestor whose left subtree is being visited. next() pops the current
+    node and descends the left spine of its right subtree.
+*/
+void AVLProfile::Cursor::pushLeftSpine(uint32_t n) {
+    while (n != NIL) {
+        stack[top++] = n;
+        n = owner->nodes[n].left;
+    }
+}
 
-    int balance = getBalance(node);
+void AVLProfile::Cursor::next() {
+    uint32_t n = stack[--top];
+    pushLeftSpine(owner->nodes[n].right);
+}
 
-    if (balance > 1 && profile.processName < node->left->profile.processName)
-        return rightRotate(node);
+string_view AVLProfile::Cursor::key() const {
+    return owner->key(stack[top - 1]);
+}
 
-    if (balance < -1 && profile.processName > node->right->profile.processName)
-        return leftRotate(node);
+const DurationStats& AVLProfile::Cursor::stats() const {
+    return owner->stats[stack[top - 1]];
+}
 
-    if (balance > 1 && profile.processName > node->left->profile.processName) {
-        node->left = leftRotate(node->left);
-        return rightRotate(node);
+AVLProfile::Cursor AVLProfile::begin() const {
+    Cursor c(this);
+    c.pushLeftSpine(root);
+    return c;
+}
+
+/*
+    lowerBound
+    ----------
+    Descends once from the root, keeping exactly the nodes >= key where
+    the search turned left: those are the ancestors an in-order walk
+    starting at the bound still has to visit.
+*/
+AVLProfile::Cursor AVLProfile::lowerBound(string_view key) const {
+    Cursor c(this);
+    Probe probe(key);
+    uint32_t cur = root;
+    while (cur != NIL) {
+        if (compare(probe, cur) <= 0) {
+            c.stack[c.top++] = cur;
+            cur = nodes[cur].left;
+        } else {
+            cur = nodes[cur].right;
+        }
     }
+    return c;
+}
 
-    if (balance < -1 && profile.processName < node->right->profile.processName) {
-        node->right = rightRotate(node->right);
-        return leftRotate(node);
+size_t AVLProfile::scanPrefix(string_view prefix,
+                              const function<void(string_view, const DurationStats&)>& fn) const {
+    size_t count = 0;
+    for (Cursor c = lowerBound(prefix); c.valid(); c.next()) {
+        string_view k = c.key();
+        if (k.substr(0, prefix.size()) != prefix) break;
+        fn(k, c.stats());
+        count++;
     }
+    return count;
+}
 
-    return node;
+size_t AVLProfile::scanRange(string_view from, string_view to,
+                             const function<void(string_view, const DurationStats&)>& fn) const {
+    size_t count = 0;
+    for (Cursor c = lowerBound(from); c.valid() && c.key() < to; c.next()) {
+        fn(c.key(), c.stats());
+        count++;
+    }
+    return count;
 }
 
 /*
     findNode
     --------
-    Recursively searches for a process name in the tree.
-    Returns the node pointer if found, nullptr otherwise.
+    Iteratively searches for a process name in the tree.
+    Returns the node id if found, NIL otherwise.
 */
-AVLProfile::Node* AVLProfile::findNode(Node* node, const string& processName) const {
-    if (!node) return nullptr;
-    if (processName == node->profile.processName) return node;
-    if (processName < node->profile.processName) return findNode(node->left, processName);
-    return findNode(node->right, processName);
+uint32_t AVLProfile::findNode(string_view processName) const {
+    Probe probe(processName);
+    uint32_t cur = root;
+    while (cur != NIL) {
+        int cmp = compare(probe, cur);
+        if (cmp == 0) return cur;
+        cur = cmp < 0 ? nodes[cur].left : nodes[cur].right;
+    }
+    return NIL;
 }
 
 /*
@@ -253,44 +636,236 @@ AVLProfile::Node* AVLProfile::findNode(Node* node, const string& processName) co
     Public interface to search for a process profile.
     Populates outProfile with the found data if successful.
 */
-bool AVLProfile::search(const string& processName, UserActionProfile& outProfile) const {
-    Node* n = findNode(root, processName);
-    if (!n) return false;
-    outProfile = n->profile;
+bool AVLProfile::search(string_view processName, UserActionProfile& outProfile) const {
+    uint32_t n = findNode(processName);
+    if (n == NIL) return false;
+    // assign() reuses the existing buffer instead of building a new string
+    outProfile.processName.assign(processName.data(), processName.size());
+    static_cast<DurationStats&>(outProfile) = stats[n];
+    return true;
+}
+
+bool AVLProfile::search(string_view processName, int& frequency, double& avgDuration) const {
+    uint32_t n = findNode(processName);
+    if (n == NIL) return false;
+    frequency = stats[n].frequency;
+    avgDuration = stats[n].avgDuration;
     return true;
 }
 
 /*
-    inorderExport
-    -------------
-    Traverses the tree in-order (sorted by process name) and applies a function.
-    Used to write data to CSV sequentially.
+    freeze
+    ------
+    Builds the read-only Eytzinger snapshot used by the monitors.
+    The in-order walk already yields the keys sorted.
 */
-void AVLProfile::inorderExport(Node* node, const function<void(const UserActionProfile&)>& fn) const {
-    if (!node) return;
-    inorderExport(node->left, fn);
-    fn(node->profile);
-    inorderExport(node->right, fn);
+FrozenProfile AVLProfile::freeze() const {
+    vector<UserActionProfile> sorted;
+    sorted.reserve(nodes.size());
+    forEach([&](const UserActionProfile& p) {
+        sorted.push_back(p);
+    });
+    return FrozenProfile(sorted);
 }
 
 /*
     exportToCSV
     -----------
     Saves the entire tree structure to a CSV file.
-    Also builds a temporary B-Tree index for demonstration.
+    Also builds a B-Tree index of each row's byte offset and saves it
+    next to the CSV, so single rows can be read back (findInCSV).
+    The rows come out in key order, so the collected offsets go straight
+    to the paged index's bulkLoad() once at the end. The index is only
+    an accelerator: if it cannot be built (e.g. a name longer than
+    DISK_BTREE_MAX_KEY) the export still succeeds and findInCSV scans.
+    Columns after AvgDuration: StdDev, Min/Max, two informational
+    percentiles and the sketch as "bucket:count" pairs separated by ';'.
 */
 bool AVLProfile::exportToCSV(const string& filename) const {
-    ofstream file(filename);
+    ofstream file(filename, ios::binary);
     if (!file.is_open()) return false;
-    BTreeIndex profileIndex;
+    vector<IndexEntry> rowOffsets;
+    rowOffsets.reserve(nodes.size());
+
+    file << "ProcessName,Frequency,AvgDuration,StdDev,MinDuration,MaxDuration,P50,P99,Buckets\n";
+
+    // Cursor keys are views into keyArena, valid for the whole export
+    for (Cursor c = begin(); c.valid(); c.next()) {
+        string_view name = c.key();
+        const DurationStats& p = c.stats();
+        rowOffsets.emplace_back(name, (uint64_t)file.tellp());
+        file << name << "," << p.frequency << "," << p.avgDuration << ","
+             << p.stddev() << "," << p.minDuration << "," << p.maxDuration << ","
+             << p.percentile(0.5) << "," << p.percentile(0.99) << ",";
+        bool first = true;
+        for (int b = 0; b < DURATION_BUCKETS; b++) {
+            if (p.buckets[b] == 0) continue;
+            if (!first) file << ";";
+            file << b << ":" << p.buckets[b];
+            first = false;
+        }
+        file << "\n";
+    }
+    file.close();
+    if (!file) return false;
 
-    file << "ProcessName,Frequency,AvgDuration\n";
+    uint64_t stamp;
+    if (!csvStamp(filename, stamp) || !saveBTreeIndexToDisk(rowOffsets, indexPathFor(filename), stamp)) {
+        std::remove(indexPathFor(filename).c_str());
+        cerr << "Warning: '" << filename << "' was written without a row index; lookups will scan it." << endl;
+    }
+    return true;
+}
 
-    inorderExport(root, [&](const UserActionProfile& p) {
-        file << p.processName << "," << p.frequency << "," << p.avgDuration << "\n";
-        profileIndex.insert(p.processName);
-    });
-    saveBTreeIndexToDisk(&profileIndex, "fingerprint_index.bin");
+string AVLProfile::indexPathFor(const string& csvFilename) {
+    const string ext = ".csv";
+    if (csvFilename.size() >= ext.size() &&
+        csvFilename.compare(csvFilename.size() - ext.size(), ext.size(), ext) == 0) {
+        return csvFilename.substr(0, csvFilename.size() - ext.size()) + "_index.bin";
+    }
+    return csvFilename + "_index.bin";
+}
+
+/*
+    findInCSV
+    ---------
+    With an index whose tag matches the CSV's stamp (csvStamp), the
+    lookup reads height() index pages and at most one CSV row, and a miss
+    is final. A missing, stale (the CSV was rewritten since) or damaged
+    index falls back to a line scan, as does a row at the indexed offset
+    that holds another name. io keeps the pages the index read either way;
+    scanned tells the two paths apart.
+*/
+bool AVLProfile::findInCSV(const string& filename, string_view processName,
+                           UserActionProfile& out, PageCacheStats* io, bool* scanned) {
+    if (scanned) *scanned = false;
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, ios::end);
+    uint64_t csvBytes = (uint64_t)file.tellg();
+
+    string line;
+    uint64_t stamp;
+    unique_ptr<DiskBTree> profileIndex(loadBTreeIndexFromDisk(indexPathFor(filename)));
+    if (profileIndex && csvStamp(filename, stamp) && profileIndex->getTag() == stamp) {
+        uint64_t offset;
+        bool hit = profileIndex->find(processName, offset);
+        if (io) *io = profileIndex->cacheStats();
+        if (!profileIndex->isDamaged()) {
+            if (!hit) return false;
+            if (offset < csvBytes) {
+                file.seekg((streamoff)offset);
+                if (getline(file, line) && parseCSVRow(line, out) && out.processName == processName) return true;
+            }
+        } else {
+            cerr << "Warning: Index '" << indexPathFor(filename) << "' is damaged; scanning the CSV." << endl;
+        }
+        file.clear();
+    } else if (io) {
+        *io = PageCacheStats();
+    }
+
+    if (scanned) *scanned = true;
+    file.seekg(0);
+    getline(file, line); // Skip header
+    while (getline(file, line)) {
+        if (line.size() > processName.size() && line[processName.size()] == ',' &&
+            line.compare(0, processName.size(), processName) == 0) {
+            return parseCSVRow(line, out);
+        }
+    }
+    return false;
+}
+
+/*
+    encodeBinary
+    ------------
+    Builds the binary fingerprint image: header, the records in key order
+    (the in-order walk), then the string pool. The node arena is in
+    insertion order, so names are re-packed in key order while encoding.
+*/
+void AVLProfile::encodeBinary(string& out) const {
+    vector<FingerprintRecord> records;
+    records.reserve(nodes.size());
+    string pool;
+    pool.reserve(keyArena.size());
+
+    uint32_t stack[64];
+    int top = 0;
+    uint32_t cur = root;
+    while (cur != NIL || top > 0) {
+        while (cur != NIL) {
+            stack[top++] = cur;
+            cur = nodes[cur].left;
+        }
+        cur = stack[--top];
+
+        FingerprintRecord r;
+        r.keyOffset = (uint32_t)pool.size();
+        r.keyLength = nodes[cur].keyLength;
+        r.setStats(stats[cur]);
+        records.push_back(r);
+        pool.append(keyArena.data() + nodes[cur].keyOffset, nodes[cur].keyLength);
+
+        cur = nodes[cur].right;
+    }
+
+    FingerprintHeader header;
+    memcpy(header.magic, FingerprintFile::MAGIC, sizeof(header.magic));
+    header.version = FINGERPRINT_FILE_VERSION;
+    header.count = records.size();
+    header.poolBytes = pool.size();
+
+    out.clear();
+    out.reserve(sizeof(header) + records.size() * sizeof(FingerprintRecord) + pool.size());
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(FingerprintRecord));
+    out.append(pool);
+}
+
+/*
+    exportToBinary
+    --------------
+    Writes the image from encodeBinary() in one go.
+*/
+bool AVLProfile::exportToBinary(const string& filename) const {
+    string image;
+    encodeBinary(image);
+
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(image.data(), (streamsize)image.size());
+    return (bool)file;
+}
+
+/*
+    importFromBinary
+    ----------------
+    Loads a binary fingerprint through one mmap; no text parsing.
+    Records are validated as sorted and unique, so an empty tree is built
+    directly with linkBalanced() (O(n), no temporary profiles); otherwise
+    existing entries are simply overwritten.
+*/
+bool AVLProfile::importFromBinary(const string& filename) {
+    FingerprintFile file;
+    if (!file.open(filename)) return false;
+
+    if (root == NIL) {
+        nodes.reserve(file.size());
+        stats.reserve(file.size());
+        keyArena.reserve(file.poolSize());
+        for (size_t i = 0; i < file.size(); i++) {
+            newNode(Probe(file.key(i)), file.record(i).toStats());
+        }
+        root = linkBalanced(0, (uint32_t)nodes.size());
+        return true;
+    }
+
+    nodes.reserve(nodes.size() + file.size());
+    keyArena.reserve(keyArena.size() + file.poolSize());
+    for (size_t i = 0; i < file.size(); i++) {
+        stats[findOrInsert(file.key(i))] = file.record(i).toStats();
+    }
     return true;
 }
 
@@ -298,41 +873,26 @@ bool AVLProfile::exportToCSV(const string& filename) const {
     importFromCSV
     -------------
     Loads profile data from a CSV file into the AVL tree.
-    Simulates checking a B-Tree index first for optimization.
+    Every row is needed here, so the row index is not consulted
+    (it serves single-row lookups, see findInCSV).
+    Rows are collected and handed to bulkLoad(); exportToCSV writes them
+    sorted, so the usual case is an O(n) build.
+    Old three-column files still load; their spread is unknown, so the
+    monitors keep using the classic mean-based limits for them.
 */
 bool AVLProfile::importFromCSV(const string& filename) {
     ifstream file(filename);
     if (!file.is_open()) return false;
-    
-    // Check secondary index first (simulation)
-    BTreeIndex* profileIndex = loadBTreeIndexFromDisk("fingerprint_index.bin");
-    if (profileIndex && profileIndex->search("cmd.exe")) {
-        cout << "[B-Tree] Profile for 'cmd.exe' found quickly via disk index ." <<endl;
-    } else {
-        cout << "[B-Tree] Index not found or key not present. Proceeding with full CSV scan." << endl;
-    }
-    
+
     string line;
     getline(file, line); // Skip header
 
+    vector<UserActionProfile> rows;
+    UserActionProfile p;
     while (getline(file, line)) {
         if (line.empty()) continue;
-
-        string name;
-        int freq;
-        double avg;
-
-        stringstream ss(line);
-        getline(ss, name, ',');
-        ss >> freq;
-        ss.ignore(1, ',');
-        ss >> avg;
-
-        UserActionProfile p(name, freq, avg);
-        insertProfileDirect(p);
-    }
-    if (profileIndex) {
-        delete profileIndex;
+        if (parseCSVRow(line, p)) rows.push_back(p);
     }
+    bulkLoad(rows);
     return true;
 }
\ No newline at end of file
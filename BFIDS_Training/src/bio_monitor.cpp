@@ -8,6 +8,8 @@
 
 // --- INCLUDES ---
 #include "avl_profile.h"
+#include "frozen_profile.h"
+#include "fingerprint_file.h"
 #include "Array_handler.h"
 #include "pointer_utils.h"
 #include "utils.h"
@@ -122,7 +124,9 @@ int main()
     AVLProfile validProfile;
     
     // Attempt to load the user's behavioral fingerprint from disk
-    if (!validProfile.importFromCSV(filename))
+    // (binary fingerprint if present, CSV otherwise)
+    if (!validProfile.importFromBinary(FingerprintFile::pathFor(filename)) &&
+        !validProfile.importFromCSV(filename))
     {
         cerr << "Error: No biometric profile found for user '" << targetUser << "'." << endl;
         cerr << "Please run bio_trainer and train as '" << targetUser << "' first." << endl;
@@ -132,6 +136,7 @@ int main()
     // Register profile in the Hash Table
     hashTable userRegistry(10);
     userRegistry.addProfile(targetUser, &validProfile);
+    cout << "[hashTable] Added profile for: " << targetUser << endl;
 
     // --- 3. GRAPH STATE MACHINE (UPDATED) ---
     arrayHandler anomalyLog;
@@ -158,8 +163,10 @@ int main()
 
     UserActionProfile keyStats;
     AVLProfile *activeProfile = userRegistry.getProfile(targetUser);
+    // Detection only reads the profile: look up through the frozen snapshot
+    FrozenProfile detectionProfile = activeProfile->freeze();
     
-    if (!activeProfile->search("Keystroke_Dynamics", keyStats))
+    if (!detectionProfile.search("Keystroke_Dynamics", keyStats))
     {
         cerr << "Error: No keystroke data found in fingerprint for " << targetUser << "." << endl;
         return 1;
@@ -168,6 +175,12 @@ int main()
     cout << "--- BIOMETRIC LIVE MONITORING (SSH MODE) ---" << endl;
     cout << "Monitoring User: " << targetUser << endl;
     cout << "Avg Key Latency: " << keyStats.avgDuration << "ms" << endl;
+
+    // Accepted latency window: learned spread (p01/p99, mean -/+ 3 sd),
+    // never wider than the classic 30% - 300% of the average
+    double lowLimit = keyStats.lowerBound(0.3);
+    double highLimit = keyStats.upperBound(3.0);
+    cout << "Accepted Range: " << lowLimit << "ms - " << highLimit << "ms" << endl;
     cout << "Start typing to verify identity... (ESC to quit)" << endl;
 
     enableRawMode();
@@ -188,8 +201,8 @@ int main()
 
         if (!firstKey && latency < 5000) 
         {
-            // Check for deviations (30% - 300% of average)
-            if (latency < keyStats.avgDuration * 0.3 || latency > keyStats.avgDuration * 3.0)
+            // Check for deviations outside the accepted range
+            if (latency < lowLimit || latency > highLimit)
             {
                 double rawSeverity = abs(latency - keyStats.avgDuration) / 10.0;
                 double cappedSeverity = (rawSeverity > 5.0) ? 5.0 : rawSeverity;
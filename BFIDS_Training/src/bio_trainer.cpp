@@ -12,6 +12,9 @@
 #include "avl_profile.h"
 #include "queue_monitor.h"
 #include "stack_monitor.h"
+#include "action_log_writer.h"
+#include "fingerprint_file.h"
+#include "fingerprint_store.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -25,8 +28,10 @@ using namespace std::chrono;
     1. Captures user keystrokes in real-time.
     2. Measures flight time (latency) between keys.
     3. Builds a statistical profile (Average Duration).
-    4. Logs training events to Stack and Queue monitors for analysis.
-    5. Exports the trained profile to a CSV file.
+    4. Logs training events to Stack and Queue monitors for analysis,
+       and appends them to data/<user>_actions.log (buffered writer).
+    5. Saves the profile incrementally (fingerprint_store.h journal) and
+       exports the final profile to the binary base and a CSV file.
 */
 
 // Configuration to handle Terminal I/O
@@ -75,19 +80,34 @@ int main() {
     cout << "Note: Mouse dynamics are disabled in SSH mode." << endl;
     cout << "Initializing systems for user: [" << username << "]..." << endl;
 
-    AVLProfile profile;
+    // --- Profile store: base .bfp + journal, saved incrementally while training ---
+    system("mkdir -p fingerprints");
+    string filename = "fingerprints/bio_fingerprints_" + username + ".csv";
+    FingerprintStore store;
+    if (!store.open(FingerprintFile::pathFor(filename), true)) return 1;
 
     // --- INTEGRATION: Initialize Monitors ---
     QueueMonitor eventQueue;
     StackMonitor eventStack;
     cout << "[System] Event Queue and Stack Monitors initialized." << endl;
 
+    // --- INTEGRATION: Persistent action log (kept open, flushed in batches) ---
+    system("mkdir -p data");
+    string actionLogFile = "data/" + username + "_actions.log";
+    ActionLogWriter actionLog;
+    actionLog.open(actionLogFile);
+
     // Enable raw mode to catch individual keystrokes
     enableRawMode();
     
     cout << "\n>>> TRAINER ACTIVE. TYPE NORMALLY." << endl;
     cout << ">>> (Press 'ESC' (or Ctrl+[) to finish training)" << endl;
 
+    // Keystrokes are folded into the profile in batches (insertOrUpdateBatch)
+    const size_t KEYSTROKE_BATCH = 64;
+    vector<DurationSample> keystrokes;
+    keystrokes.reserve(KEYSTROKE_BATCH);
+
     char c;
     auto lastKeyTime = high_resolution_clock::now();
     bool firstKey = true;
@@ -108,16 +128,23 @@ int main() {
             cout << "\r[KEY] Latency: " << latency << "ms   " << flush; // \r overwrites line
             
             // Update the statistical model in the AVL Tree
-            profile.insertOrUpdate("Keystroke_Dynamics", latency);
+            keystrokes.push_back(DurationSample("Keystroke_Dynamics", latency));
+            if (keystrokes.size() == KEYSTROKE_BATCH) {
+                store.insertOrUpdateBatch(keystrokes);
+                store.flush();  // Journal append: only the changed profile
+                keystrokes.clear();
+            }
 
             // --- INTEGRATION: Log to Queue and Stack ---
             // Use dynamic username
             UserAction act(username, "KeyPress", "SSH_Keyboard", latency);
             eventQueue.enqueueAction(act);
             eventStack.pushAction(act);
+            actionLog.append(act);
         }
         firstKey = false;
     }
+    store.insertOrUpdateBatch(keystrokes);
 
     // Restore terminal before printing summary
     disableRawMode();
@@ -128,14 +155,22 @@ int main() {
     cout << "Total Events Queued: " << eventQueue.getSize() << endl;
     cout << "Total Events Stacked: " << eventStack.getSize() << endl;
 
+    actionLog.close();
+    const ActionLogWriterStats& logStats = actionLog.getStats();
+    cout << "Action Log: " << logStats.records << " events, " << logStats.bytesWritten
+         << " bytes in " << logStats.flushes << " batch(es) -> '" << actionLogFile << "'" << endl;
+    if (logStats.bytesDropped > 0) {
+        cout << "Warning: " << logStats.bytesDropped << " bytes of the action log could not be written." << endl;
+    }
+
     cout << "Saving Profile..." << endl;
     
-    // --- CHANGE: Create directory and update path ---
-    system("mkdir -p fingerprints");
-    string filename = "fingerprints/bio_fingerprints_" + username + ".csv";
-    
-    // Serialize the AVL Tree to CSV
-    profile.exportToCSV(filename);
+    // Fold the journal into the binary base bio_monitor loads first,
+    // and write the human-readable CSV next to it
+    store.flush();
+    store.compact(false);
+    store.getProfile().exportToCSV(filename);
+    store.close();
     cout << "Saved to '" << filename << "'." << endl;
 
     return 0;
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "btree_index.h"
+
+using namespace std;
+
+/*
+    btree_bench.cpp
+    ---------------
+    Fanout sweep for BTreeIndex.
+    For each minimum degree t (3 = the old fixed value, up to 128) it
+    inserts N distinct process names in random order, looks each one up
+    again (shuffled) and reports ns/op and bytes per key. The last column
+    is the bottom-up bulkLoad() of the same names, already sorted.
+
+    Usage: ./btree_bench [N] [--long]   (default 10000000)
+    --long uses path-style names ("C:\Windows\System32\proc_N.exe") whose
+    first 16 bytes are all equal, so every comparison falls back to the
+    full key: the worst case for the inline prefixes.
+*/
+
+typedef chrono::steady_clock Clock;
+
+static double msSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = 10000000;
+    bool longNames = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--long") == 0) longNames = true;
+        else n = (size_t)atoll(argv[i]);
+    }
+
+    const string dir = longNames ? "C:\\Windows\\System32\\" : "";
+    vector<string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        keys.push_back(dir + "proc_" + to_string(i * 2654435761u % 1000000007u) + (longNames ? ".exe" : ""));
+    }
+    mt19937_64 rng(42);
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<string> probes = keys;
+    shuffle(probes.begin(), probes.end(), rng);
+    vector<string> sortedKeys = keys;
+    sort(sortedKeys.begin(), sortedKeys.end());
+    vector<IndexEntry> sorted;
+    sorted.reserve(n);
+    for (size_t i = 0; i < n; i++) sorted.emplace_back(sortedKeys[i], i);
+
+    cout << "keys=" << n << (longNames ? " (long names)" : "") << "\n"
+         << setw(6) << "t" << setw(10) << "max keys" << setw(14) << "insert ns/op"
+         << setw(14) << "lookup ns/op" << setw(12) << "bytes/key" << setw(14) << "bulk ns/key" << "\n";
+
+    bool ok = true;
+    const int degrees[] = { 3, 4, 8, 16, 32, 64, 128 };
+    for (int t : degrees) {
+        BTreeIndex index(t);
+
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < n; i++) index.insert(keys[i], i);
+        double insertMs = msSince(start);
+
+        size_t found = 0;
+        uint64_t value = 0, sum = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < n; i++) {
+            if (index.find(probes[i], value)) {
+                found++;
+                sum += value;
+            }
+        }
+        double lookupMs = msSince(start);
+
+        // Every value 0..n-1 was stored once
+        ok = ok && found == n && index.size() == n && sum == (uint64_t)n * (n - 1) / 2;
+        size_t insertedBytes = index.memoryUsage();
+
+        index.clear();
+        start = Clock::now();
+        ok = index.bulkLoad(sorted) && ok;
+        double bulkMs = msSince(start);
+        ok = ok && index.size() == n && index.search(probes[0]);
+        cout << fixed << setprecision(1)
+             << setw(6) << t << setw(10) << 2 * t - 1
+             << setw(14) << insertMs * 1e6 / n << setw(14) << lookupMs * 1e6 / n
+             << setw(12) << (double)insertedBytes / n << setw(14) << bulkMs * 1e6 / n << "\n";
+    }
+
+    if (!ok) cout << "ERROR: lookups did not return every inserted key.\n";
+    return ok ? 0 : 1;
+}
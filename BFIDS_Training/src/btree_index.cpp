@@ -10,171 +10,343 @@ using namespace std;
     ---------------
     Implements a B-Tree data structure.
     Optimized for systems that read/write large blocks of data (like disk storage).
-    
+    Nodes live in flat arrays indexed by node number, so a node's search
+    keys (the 16-byte prefixes) are contiguous and a lookup walks a few
+    cache lines per level instead of one std::string per key.
+
     Key DSA Concepts:
         - Multi-way Search Tree
         - Splitting full nodes
         - Key redistribution
+        - Branch-free binary search
 */
 
-// --- BTreeNode Implementation ---
+// --- Key helpers ---
 
-BTreeNode::BTreeNode(bool leaf_flag) : n(0), leaf(leaf_flag) {
-    // Explicit use of C-style array initialization via memset
-    memset(children, 0, sizeof(BTreeNode*) * MAX_CHILDREN);
+// First 16 bytes, big-endian and zero padded: integer order == string order
+BTreeIndex::KeyPrefix BTreeIndex::prefixOf(string_view k) {
+    uint64_t w[2];
+    for (int h = 0; h < 2; h++) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < 8; i++) {
+            size_t pos = h * 8 + i;
+            unsigned char c = pos < k.size() ? (unsigned char)k[pos] : 0;
+            v = (v << 8) | c;
+        }
+        w[h] = v;
+    }
+    return KeyPrefix{ w[0], w[1] };
+}
+
+// FNV-1a (32-bit)
+uint32_t BTreeIndex::hashOf(string_view k) {
+    uint32_t h = 2166136261u;
+    for (unsigned char c : k) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline bool prefixLess(uint64_t ahi, uint64_t alo, uint64_t bhi, uint64_t blo) {
+    // Bitwise, so the compiler emits flag arithmetic rather than branches
+    return (ahi < bhi) | ((ahi == bhi) & (alo < blo));
 }
 
 // --- BTreeIndex Implementation ---
 
+BTreeIndex::BTreeIndex(int minDegree) : root(NIL), count(0) {
+    t = max(2, min(minDegree, BTREE_MAX_DEGREE));
+    maxKeys = 2 * t - 1;
+}
+
+void BTreeIndex::clear() {
+    info.clear();
+    prefixes.clear();
+    entries.clear();
+    children.clear();
+    keyArena.clear();
+    root = NIL;
+    count = 0;
+}
+
+size_t BTreeIndex::memoryUsage() const {
+    return info.capacity() * sizeof(NodeInfo) + prefixes.capacity() * sizeof(KeyPrefix) +
+           entries.capacity() * sizeof(Entry) + children.capacity() * sizeof(uint32_t) +
+           keyArena.capacity();
+}
+
 /*
-    destroy
+    newNode
     -------
-    Recursively deletes all nodes in the B-Tree.
-    Used by the destructor to prevent memory leaks.
+    Appends an empty node: maxKeys slots and maxKeys + 1 child links.
+    Returns its index (the arrays may move, so nodes are never held by
+    pointer across this call).
 */
-void BTreeIndex::destroy(BTreeNode* node) {
-    if (!node) return;
+uint32_t BTreeIndex::newNode(bool leaf) {
+    uint32_t x = (uint32_t)info.size();
+    info.push_back(NodeInfo{ 0, leaf });
+    prefixes.resize(prefixes.size() + maxKeys);
+    entries.resize(entries.size() + maxKeys);
+    children.resize(children.size() + maxKeys + 1, NIL);
+    return x;
+}
 
-    for (int i = 0; i <= node->n; ++i) {
-        if (node->children[i]) {
-            destroy(node->children[i]);
-        }
+string_view BTreeIndex::keyAt(size_t slot) const {
+    return string_view(keyArena.data() + entries[slot].keyOffset, entries[slot].keyLength);
+}
+
+void BTreeIndex::moveSlot(size_t from, size_t to) {
+    prefixes[to] = prefixes[from];
+    entries[to] = entries[from];
+}
+
+bool BTreeIndex::matches(size_t slot, const KeyPrefix& kp, uint32_t kh, string_view k) const {
+    return prefixes[slot] == kp && entries[slot].hash == kh && keyAt(slot) == k;
+}
+
+/*
+    lowerBound
+    ----------
+    Position of the first key >= k in node x, by a branch-free binary
+    search: the loop runs log2(n) times whatever the data, and each step
+    is a conditional add instead of a jump the CPU has to predict.
+    Steps only read the packed prefixes; the full key is compared when a
+    prefix ties with k's (names sharing their first 16 bytes).
+*/
+int BTreeIndex::lowerBound(uint32_t x, const KeyPrefix& kp, string_view k) const {
+    int n = info[x].n;
+    if (n == 0) return 0;
+
+    size_t baseSlot = (size_t)x * maxKeys;
+    const KeyPrefix* first = &prefixes[baseSlot];
+    auto less = [&](const KeyPrefix* p) {
+        if (*p == kp) return keyAt(baseSlot + (p - first)) < k;
+        return prefixLess(p->hi, p->lo, kp.hi, kp.lo);
+    };
+
+    const KeyPrefix* base = first;
+    int len = n;
+    while (len > 1) {
+        int half = len / 2;
+        base += half * (int)less(base + half);
+        len -= half;
     }
-    delete node;
+    return (int)(base - first) + (int)less(base);
 }
 
 /*
     insert
     ------
     Main interface to insert a key into the B-Tree.
-    Handles the special case where the root is full and needs to split.
+    Handles the special case where the root is full and needs to split,
+    then walks down splitting full children on the way (insertNonFull),
+    so the leaf always has room. An existing key only gets its value
+    replaced.
 */
-void BTreeIndex::insert(const std::string& k) {
-    if (root == nullptr) {
-        root = new BTreeNode(true);
-        root->keys[0] = k;
-        root->n = 1;
-    } else {
-        // If root is full, the tree must grow in height (disk optimization)
-        if (root->n == MAX_KEYS) {
-            BTreeNode* s = new BTreeNode(false);
-            s->children[0] = root;
-
-            // Split the full root
-            splitChild(s, 0, root);
-
-            // Determine which child (new or old) receives the key
-            int i = 0;
-            if (s->keys[0] < k) i++;
-            insertNonFull(s->children[i], k);
-
-            root = s;
-        } else {
-            insertNonFull(root, k);
+void BTreeIndex::insert(string_view k, uint64_t value) {
+    KeyPrefix kp = prefixOf(k);
+    uint32_t kh = hashOf(k);
+
+    if (root == NIL) root = newNode(true);
+
+    // If root is full, the tree must grow in height (disk optimization)
+    if (info[root].n == maxKeys) {
+        uint32_t s = newNode(false);
+        children[(size_t)s * (maxKeys + 1)] = root;
+        root = s;
+        splitChild(s, 0);
+    }
+
+    uint32_t x = root;
+    while (true) {
+        size_t baseSlot = (size_t)x * maxKeys;
+        int i = lowerBound(x, kp, k);
+        if (i < info[x].n && matches(baseSlot + i, kp, kh, k)) {
+            entries[baseSlot + i].value = value;
+            return;
+        }
+
+        if (info[x].leaf) {
+            // Shift larger keys right and place the new one
+            for (int j = info[x].n; j > i; j--) moveSlot(baseSlot + j - 1, baseSlot + j);
+            prefixes[baseSlot + i] = kp;
+            entries[baseSlot + i] = Entry{ value, kh, (uint32_t)keyArena.size(), (uint32_t)k.size() };
+            keyArena.insert(keyArena.end(), k.begin(), k.end());
+            info[x].n++;
+            count++;
+            return;
+        }
+
+        uint32_t c = children[(size_t)x * (maxKeys + 1) + i];
+        if (info[c].n == maxKeys) {
+            splitChild(x, i);
+
+            // The promoted median now sits at slot i
+            size_t mid = baseSlot + i;
+            if (matches(mid, kp, kh, k)) {
+                entries[mid].value = value;
+                return;
+            }
+            bool goRight = (prefixes[mid] == kp) ? keyAt(mid) < k
+                                                  : prefixLess(prefixes[mid].hi, prefixes[mid].lo, kp.hi, kp.lo);
+            if (goRight) i++;
+            c = children[(size_t)x * (maxKeys + 1) + i];
         }
+        x = c;
     }
 }
 
 /*
     splitChild
     ----------
-    Splits a full child node (y) into two nodes.
+    Splits the full child i of x into two nodes of t - 1 keys.
     Promotes the median key to the parent node (x).
     Essential for keeping the B-Tree balanced.
 */
-void BTreeIndex::splitChild(BTreeNode* x, int i, BTreeNode* y) {
-    BTreeNode* z = new BTreeNode(y->leaf);
-    z->n = T - 1;
+void BTreeIndex::splitChild(uint32_t x, int i) {
+    const size_t fan = (size_t)maxKeys + 1;
+    uint32_t y = children[x * fan + i];
+    uint32_t z = newNode(info[y].leaf);
+    size_t xs = (size_t)x * maxKeys, ys = (size_t)y * maxKeys, zs = (size_t)z * maxKeys;
 
-    // 1. Copy the last T-1 keys of y to z (using array index manipulation)
-    for (int j = 0; j < T - 1; j++) {
-        z->keys[j] = y->keys[j + T];
-    }
+    // 1. Copy the last t-1 keys of y to z
+    for (int j = 0; j < t - 1; j++) moveSlot(ys + j + t, zs + j);
 
-    // 2. Copy the last T children of y to z, if y is not a leaf
-    if (!y->leaf) {
-        for (int j = 0; j < T; j++) {
-            z->children[j] = y->children[j + T];
-            y->children[j + T] = nullptr; // Clear pointers from y
+    // 2. Copy the last t children of y to z, if y is not a leaf
+    if (!info[y].leaf) {
+        for (int j = 0; j < t; j++) {
+            children[z * fan + j] = children[y * fan + j + t];
+            children[y * fan + j + t] = NIL;
         }
     }
+    info[z].n = (uint16_t)(t - 1);
+    info[y].n = (uint16_t)(t - 1);
 
-    y->n = T - 1; // y now has T-1 keys
+    // 3. Shift children of x to make space for z (new child)
+    for (int j = info[x].n; j >= i + 1; j--) children[x * fan + j + 1] = children[x * fan + j];
+    children[x * fan + i + 1] = z;
 
-    // 3. Shift children pointers in x to make space for z (new child)
-    for (int j = x->n; j >= i + 1; j--) {
-        x->children[j + 1] = x->children[j];
-    }
-    x->children[i + 1] = z;
-
-    // 4. Shift keys in x to make space for the key promoted from y
-    for (int j = x->n - 1; j >= i; j--) {
-        x->keys[j + 1] = x->keys[j];
-    }
-    x->keys[i] = y->keys[T - 1]; // Promote median key
-    x->n = x->n + 1;
+    // 4. Shift keys of x to make space for the key promoted from y
+    for (int j = info[x].n - 1; j >= i; j--) moveSlot(xs + j, xs + j + 1);
+    moveSlot(ys + t - 1, xs + i); // Promote median key
+    info[x].n++;
 }
 
 /*
-    insertNonFull
-    -------------
-    Inserts a key into a node that is not full.
-    Traverses down the tree to finding the correct leaf position.
-    Splits children on the way down if they are full.
+    bulkLoad
+    --------
+    Bottom-up build from sorted keys, no splits:
+    1. Cut the keys into leaves of about fill * maxKeys keys; the key
+       between two neighbouring leaves is held back as their separator.
+    2. The separators form the next level, cut the same way, with the
+       nodes just built as children. Repeat until one node (the root).
+    The node count per level keeps every node within [t - 1, 2t - 1]
+    keys, and the keys are spread evenly over the nodes of a level.
 */
-void BTreeIndex::insertNonFull(BTreeNode* x, const std::string& k) {
-    int i = x->n - 1;
-
-    if (x->leaf) {
-        // Find location to insert key (while shifting larger keys right)
-        while (i >= 0 && x->keys[i] > k) {
-            x->keys[i + 1] = x->keys[i];
-            i--;
-        }
-        x->keys[i + 1] = k;
-        x->n = x->n + 1;
-    } else {
-        // Find the child which is going to have the new key
-        while (i >= 0 && x->keys[i] > k) {
-            i--;
-        }
-        i++;
+bool BTreeIndex::bulkLoad(const vector<IndexEntry>& sorted, double fill) {
+    clear();
+    size_t bytes = 0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        if (i > 0 && !(sorted[i - 1].first < sorted[i].first)) return false;
+        bytes += sorted[i].first.size();
+    }
+    if (sorted.empty()) return true;
+
+    int perNode = (int)(fill * maxKeys + 0.5);
+    perNode = max(t - 1, min(perNode, maxKeys));
+    const size_t fan = (size_t)maxKeys + 1;
+
+    // Current level's items, starting with every key
+    vector<KeyPrefix> levelPrefixes;
+    vector<Entry> levelEntries;
+    levelPrefixes.reserve(sorted.size());
+    levelEntries.reserve(sorted.size());
+    keyArena.reserve(bytes);
+    for (const IndexEntry& e : sorted) {
+        levelPrefixes.push_back(prefixOf(e.first));
+        levelEntries.push_back(Entry{ e.second, hashOf(e.first), (uint32_t)keyArena.size(), (uint32_t)e.first.size() });
+        keyArena.insert(keyArena.end(), e.first.begin(), e.first.end());
+    }
+    count = sorted.size();
 
-        if (x->children[i]->n == MAX_KEYS) {
-            splitChild(x, i, x->children[i]);
+    size_t estimate = sorted.size() / perNode + sorted.size() / ((size_t)perNode * perNode) + 2;
+    info.reserve(estimate);
+    prefixes.reserve(estimate * maxKeys);
+    entries.reserve(estimate * maxKeys);
+    children.reserve(estimate * fan);
+
+    vector<uint32_t> levelChildren;     // Empty for the leaf level
+    bool leaf = true;
+    while (true) {
+        size_t n = levelPrefixes.size();
+        // m nodes hold n - (m - 1) keys; the clamp keeps each in [t - 1, maxKeys]
+        size_t fewest = (n + 1 + maxKeys) / (maxKeys + 1);
+        size_t most = max(fewest, (n + 1) / t);
+        size_t m = min(max((n + 1 + perNode) / (perNode + 1), fewest), most);
+
+        vector<KeyPrefix> upPrefixes;
+        vector<Entry> upEntries;
+        vector<uint32_t> nodes;
+        nodes.reserve(m);
+        size_t pos = 0, child = 0;
+        for (size_t j = 0; j < m; j++) {
+            size_t keysLeft = n - pos - (m - 1 - j);
+            size_t size = keysLeft / (m - j);
+            uint32_t x = newNode(leaf);
+            size_t baseSlot = (size_t)x * maxKeys;
+            for (size_t s = 0; s < size; s++) {
+                prefixes[baseSlot + s] = levelPrefixes[pos + s];
+                entries[baseSlot + s] = levelEntries[pos + s];
+            }
+            if (!leaf) {
+                for (size_t s = 0; s <= size; s++) children[x * fan + s] = levelChildren[child++];
+            }
+            info[x].n = (uint16_t)size;
+            pos += size;
+            nodes.push_back(x);
 
-            if (x->keys[i] < k) {
-                i++;
+            if (j + 1 < m) {
+                upPrefixes.push_back(levelPrefixes[pos]);
+                upEntries.push_back(levelEntries[pos]);
+                pos++;
             }
         }
-        insertNonFull(x->children[i], k); // **Recursion**
+
+        if (m == 1) {
+            root = nodes[0];
+            return true;
+        }
+        levelPrefixes.swap(upPrefixes);
+        levelEntries.swap(upEntries);
+        levelChildren.swap(nodes);
+        leaf = false;
     }
 }
 
 // ======================= SEARCH IMPLEMENTATION =======================
 
 /*
-    searchNode
-    ----------
-    Recursively searches the tree for a key.
-    Uses linear search within the node (could be optimized to binary search).
+    find
+    ----
+    Iterative descent; one lowerBound per level. The value stored with
+    the key is returned when it is found.
 */
-BTreeNode* BTreeIndex::searchNode(BTreeNode* x, const std::string& k) {
-    if (x == nullptr) return nullptr;
-
-    int i = 0;
-    while (i < x->n && k > x->keys[i]) {
-        i++;
-    }
+bool BTreeIndex::find(string_view k, uint64_t& value) const {
+    if (root == NIL) return false;
+    KeyPrefix kp = prefixOf(k);
+    uint32_t kh = hashOf(k);
 
-    if (i < x->n && k == x->keys[i]) {
-        return x;
-    }
-
-    if (x->leaf) {
-        return nullptr;
-    } else {
-        return searchNode(x->children[i], k);
+    uint32_t x = root;
+    while (true) {
+        size_t baseSlot = (size_t)x * maxKeys;
+        int i = lowerBound(x, kp, k);
+        if (i < info[x].n && matches(baseSlot + i, kp, kh, k)) {
+            value = entries[baseSlot + i].value;
+            return true;
+        }
+        if (info[x].leaf) return false;
+        x = children[(size_t)x * (maxKeys + 1) + i];
     }
 }
 
@@ -184,7 +356,30 @@ BTreeNode* BTreeIndex::searchNode(BTreeNode* x, const std::string& k) {
     Public interface for searching a key.
     Returns true if found, false otherwise.
 */
-bool BTreeIndex::search(const std::string& k) {
-    // This search is O(log_T n), making it ideal for disk-based lookups.
-    return searchNode(root, k) != nullptr;
-}
\ No newline at end of file
+bool BTreeIndex::search(string_view k) const {
+    // This search is O(log_t n), making it ideal for disk-based lookups.
+    uint64_t value;
+    return find(k, value);
+}
+
+// ======================= TRAVERSAL =======================
+
+/*
+    forEachNode
+    -----------
+    In-order walk: child i, then key i, ..., then the last child.
+*/
+void BTreeIndex::forEachNode(uint32_t x, const function<void(string_view, uint64_t)>& fn) const {
+    const size_t fan = (size_t)maxKeys + 1;
+    size_t baseSlot = (size_t)x * maxKeys;
+    bool leaf = info[x].leaf;
+    for (int i = 0; i < info[x].n; i++) {
+        if (!leaf) forEachNode(children[x * fan + i], fn);
+        fn(keyAt(baseSlot + i), entries[baseSlot + i].value);
+    }
+    if (!leaf) forEachNode(children[x * fan + info[x].n], fn);
+}
+
+void BTreeIndex::forEach(const function<void(string_view, uint64_t)>& fn) const {
+    if (root != NIL) forEachNode(root, fn);
+}
@@ -0,0 +1,327 @@
+#include "concurrent_profile.h"
+#include "avl_profile.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+/*
+    concurrent_profile.cpp
+    ----------------------
+    Persistent AVL tree + two-counter RCU.
+
+    Ownership: every node pointer stored in a node (or a Version root)
+    holds one reference. Only the writer (under writeLock) touches
+    reference counts, so they are plain integers; readers just follow
+    pointers of a version that cannot be freed while they are registered.
+*/
+
+const size_t KEY_CHUNK_BYTES = 64 * 1024;
+
+ConcurrentProfile::ConcurrentProfile()
+    : current(new Version{ nullptr, 0 }),
+      epoch(0),
+      chunkUsed(0),
+      chunkSize(0),
+      batchId(0),
+      workingSize(0) {
+    readers[0].store(0);
+    readers[1].store(0);
+}
+
+// No snapshot may outlive the profile
+ConcurrentProfile::~ConcurrentProfile() {
+    reclaim(true);
+    Version* v = current.load();
+    decRef(v->root);
+    delete v;
+}
+
+// ===================== READERS =====================
+
+/*
+    snapshot
+    --------
+    Registers in the counter of the current epoch, then re-reads the
+    epoch: if a publish flipped it in between, the registration may have
+    gone unseen, so it is undone and retried. Never waits on a lock.
+*/
+ConcurrentProfile::Snapshot ConcurrentProfile::snapshot() const {
+    for (;;) {
+        uint64_t e = epoch.load();
+        int parity = (int)(e & 1);
+        readers[parity].fetch_add(1);
+        if (epoch.load() == e) return Snapshot(this, current.load(), parity);
+        readers[parity].fetch_sub(1);
+    }
+}
+
+ConcurrentProfile::Snapshot::Snapshot(Snapshot&& other) noexcept
+    : owner(other.owner), version(other.version), parity(other.parity) {
+    other.owner = nullptr;
+}
+
+ConcurrentProfile::Snapshot::~Snapshot() {
+    if (owner) owner->readers[parity].fetch_sub(1);
+}
+
+const DurationStats* ConcurrentProfile::Snapshot::find(string_view processName) const {
+    const Node* n = version->root;
+    while (n) {
+        int c = processName.compare(n->key);
+        if (c == 0) return &n->stats;
+        n = (c < 0) ? n->left : n->right;
+    }
+    return nullptr;
+}
+
+bool ConcurrentProfile::Snapshot::search(string_view processName, UserActionProfile& outProfile) const {
+    const DurationStats* s = find(processName);
+    if (!s) return false;
+    outProfile.processName.assign(processName.data(), processName.size());
+    static_cast<DurationStats&>(outProfile) = *s;
+    return true;
+}
+
+void ConcurrentProfile::Snapshot::forEach(const function<void(const UserActionProfile&)>& fn) const {
+    const Node* stack[64];
+    int top = 0;
+    const Node* cur = version->root;
+    while (cur || top > 0) {
+        while (cur) {
+            stack[top++] = cur;
+            cur = cur->left;
+        }
+        cur = stack[--top];
+        fn(UserActionProfile(string(cur->key), cur->stats));
+        cur = cur->right;
+    }
+}
+
+// ===================== WRITERS =====================
+
+void ConcurrentProfile::insertOrUpdate(string_view processName, double duration) {
+    lock_guard<mutex> lock(writeLock);
+    pending.push_back({ (uint32_t)pendingKeys.size(), (uint32_t)processName.size(), duration, -1 });
+    pendingKeys.append(processName.data(), processName.size());
+}
+
+void ConcurrentProfile::mergeProfile(const UserActionProfile& profile) {
+    lock_guard<mutex> lock(writeLock);
+    pending.push_back({ (uint32_t)pendingKeys.size(), (uint32_t)profile.processName.size(), 0.0,
+                        (int32_t)pendingMerges.size() });
+    pendingKeys += profile.processName;
+    pendingMerges.push_back(static_cast<const DurationStats&>(profile));
+}
+
+/*
+    publish
+    -------
+    Applies the queued updates on top of the current version. The first
+    update reaching a node copies it (and so its whole path); later ones
+    in the same batch find the copy and change it in place. The finished
+    root is published with one atomic swap.
+*/
+size_t ConcurrentProfile::publish() {
+    lock_guard<mutex> lock(writeLock);
+    if (pending.empty()) {
+        reclaim(false);
+        return 0;
+    }
+
+    const Version* base = current.load();
+    batchId++;
+    workingSize = base->size;
+    Node* root = base->root;
+    incRef(root);   // The new version's reference
+    for (const PendingUpdate& u : pending) {
+        root = apply(root, string_view(pendingKeys.data() + u.keyOffset, u.keyLength), u);
+    }
+
+    size_t applied = pending.size();
+    pending.clear();
+    pendingKeys.clear();
+    pendingMerges.clear();
+
+    publishVersion(new Version{ root, workingSize });
+    return applied;
+}
+
+void ConcurrentProfile::loadFrom(const AVLProfile& profile) {
+    vector<UserActionProfile> sorted;
+    sorted.reserve(profile.size());
+    profile.forEach([&](const UserActionProfile& p) { sorted.push_back(p); });
+
+    lock_guard<mutex> lock(writeLock);
+    batchId++;
+    Node* root = buildBalanced(sorted, 0, sorted.size());
+    publishVersion(new Version{ root, sorted.size() });
+}
+
+void ConcurrentProfile::reclaim() {
+    lock_guard<mutex> lock(writeLock);
+    reclaim(false);
+}
+
+/*
+    publishVersion
+    --------------
+    Swap first, then flip the epoch: a reader whose registration is
+    validated after the flip can only load the new version (or a later
+    one). Readers validated before it may hold the old version whichever
+    counter they used, since a reader loads `current` only after
+    registering and can be overtaken by any number of publishes.
+*/
+void ConcurrentProfile::publishVersion(Version* next) {
+    Version* old = current.exchange(next);
+    epoch.fetch_add(1);
+    retired.push_back({ old, { false, false } });
+    reclaim(false);
+}
+
+/*
+    reclaim
+    -------
+    Once a counter reads zero after the retirement, every reader that was
+    registered in it before the flip has left; anyone registering in it
+    later either fails validation (stale epoch) or sees a newer version.
+    A retired version is freed when both counters have passed that point,
+    not necessarily at the same moment.
+*/
+void ConcurrentProfile::reclaim(bool all) {
+    bool idle[2] = { readers[0].load() == 0, readers[1].load() == 0 };
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        Retired& r = retired[i];
+        r.drained[0] = r.drained[0] || idle[0];
+        r.drained[1] = r.drained[1] || idle[1];
+        if (all || (r.drained[0] && r.drained[1])) {
+            decRef(r.version->root);
+            delete r.version;
+        } else {
+            retired[kept++] = r;
+        }
+    }
+    retired.resize(kept);
+}
+
+// ===================== TREE =====================
+
+// Keys are never removed, so they go to an append-only arena whose
+// chunks never move; node copies share the same bytes.
+string_view ConcurrentProfile::internKey(string_view key) {
+    if (keyChunks.empty() || chunkUsed + key.size() > chunkSize) {
+        chunkSize = max(KEY_CHUNK_BYTES, key.size());
+        keyChunks.emplace_back(new char[chunkSize]);
+        chunkUsed = 0;
+    }
+    char* dst = keyChunks.back().get() + chunkUsed;
+    if (!key.empty()) memcpy(dst, key.data(), key.size());
+    chunkUsed += key.size();
+    return string_view(dst, key.size());
+}
+
+ConcurrentProfile::Node* ConcurrentProfile::newLeaf(string_view key) {
+    return new Node{ internKey(key), nullptr, nullptr, 1, 1, batchId, DurationStats() };
+}
+
+/*
+    own
+    ---
+    Returns a node this batch may modify: n itself if this batch created
+    it, otherwise a copy. The caller's reference moves from n to the copy.
+*/
+ConcurrentProfile::Node* ConcurrentProfile::own(Node* n) {
+    if (n->batch == batchId) return n;
+    Node* copy = new Node(*n);
+    copy->refs = 1;
+    copy->batch = batchId;
+    incRef(copy->left);
+    incRef(copy->right);
+    decRef(n);
+    return copy;
+}
+
+void ConcurrentProfile::incRef(Node* n) {
+    if (n) n->refs++;
+}
+
+void ConcurrentProfile::decRef(Node* n) {
+    if (n && --n->refs == 0) {
+        decRef(n->left);
+        decRef(n->right);
+        delete n;
+    }
+}
+
+void ConcurrentProfile::updateHeight(Node* n) {
+    n->height = 1 + max(height(n->left), height(n->right));
+}
+
+// y is owned by this batch; its left child is made so before moving
+ConcurrentProfile::Node* ConcurrentProfile::rightRotate(Node* y) {
+    Node* x = own(y->left);
+    y->left = x->right;
+    x->right = y;
+    updateHeight(y);
+    updateHeight(x);
+    return x;
+}
+
+ConcurrentProfile::Node* ConcurrentProfile::leftRotate(Node* x) {
+    Node* y = own(x->right);
+    x->right = y->left;
+    y->left = x;
+    updateHeight(x);
+    updateHeight(y);
+    return y;
+}
+
+ConcurrentProfile::Node* ConcurrentProfile::rebalance(Node* n) {
+    int balance = height(n->left) - height(n->right);
+    if (balance > 1) {
+        n->left = own(n->left);
+        if (height(n->left->left) < height(n->left->right)) n->left = leftRotate(n->left);
+        return rightRotate(n);
+    }
+    if (balance < -1) {
+        n->right = own(n->right);
+        if (height(n->right->right) < height(n->right->left)) n->right = rightRotate(n->right);
+        return leftRotate(n);
+    }
+    return n;
+}
+
+ConcurrentProfile::Node* ConcurrentProfile::apply(Node* n, string_view key, const PendingUpdate& u) {
+    if (!n) {
+        n = newLeaf(key);
+        workingSize++;
+    } else {
+        n = own(n);
+        int c = key.compare(n->key);
+        if (c != 0) {
+            size_t before = workingSize;
+            if (c < 0) n->left = apply(n->left, key, u);
+            else n->right = apply(n->right, key, u);
+            if (workingSize == before) return n;   // Stats-only update: shape unchanged
+            updateHeight(n);
+            return rebalance(n);
+        }
+    }
+
+    if (u.mergeIndex < 0) n->stats.add(u.duration);
+    else n->stats.merge(pendingMerges[u.mergeIndex]);
+    return n;
+}
+
+ConcurrentProfile::Node* ConcurrentProfile::buildBalanced(const vector<UserActionProfile>& sorted, size_t lo, size_t hi) {
+    if (lo >= hi) return nullptr;
+    size_t mid = lo + (hi - lo) / 2;
+    Node* n = newLeaf(sorted[mid].processName);
+    n->stats = sorted[mid];
+    n->left = buildBalanced(sorted, lo, mid);
+    n->right = buildBalanced(sorted, mid + 1, hi);
+    updateHeight(n);
+    return n;
+}
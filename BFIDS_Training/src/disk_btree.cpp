@@ -0,0 +1,808 @@
+#include "disk_btree.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+/*
+    disk_btree.cpp
+    --------------
+    Page file + B+Tree on top of it.
+    Every node is one DISK_PAGE_SIZE page, so a lookup costs one page
+    read per level and the tree height is log_B(n) with B in the
+    hundreds for typical process names.
+*/
+
+static const char PAGE_FILE_MAGIC[4] = { 'B', 'F', 'P', 'G' };
+static const char BTREE_MAGIC[4] = { 'B', 'F', 'B', 'T' };
+static const uint32_t BTREE_VERSION = 1;
+
+struct PageFileHeader {
+    char magic[4];
+    uint32_t pageSize;
+    uint32_t pageCount;
+    uint32_t freeHead;
+};
+
+struct TreeMeta {
+    char magic[4];
+    uint32_t version;
+    uint32_t root;
+    uint32_t levels;
+    uint64_t count;
+    uint64_t tag;
+};
+
+struct NodeHeader {
+    uint8_t leaf;
+    uint8_t pad;
+    uint16_t count;
+    uint32_t next;
+    uint64_t child0;
+};
+
+struct Slot {
+    uint16_t keyOffset;
+    uint16_t keyLength;
+    uint32_t pad;
+    uint64_t value;
+};
+
+// ===================== PAGE CACHE =====================
+
+PageCache::PageCache(size_t capacityPages)
+    : fd(-1), writable(false), capacity(max<size_t>(capacityPages, 4)), tick(0), pageCount(0), freeHead(0) {}
+
+PageCache::~PageCache() {
+    close();
+}
+
+bool PageCache::open(const string& path, bool create, bool canWrite) {
+    close();
+    int flags = canWrite ? O_RDWR : O_RDONLY;
+    if (create) flags |= O_CREAT | O_TRUNC;
+    fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) return false;
+
+    writable = canWrite;
+    stats = PageCacheStats();
+    tick = 0;
+
+    if (create) {
+        pageCount = 1;
+        freeHead = 0;
+        fetch(0, false)->dirty = true;
+        return true;
+    }
+
+    PageFileHeader header;
+    struct stat st;
+    if (::pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || fstat(fd, &st) != 0 ||
+        memcmp(header.magic, PAGE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.pageSize != DISK_PAGE_SIZE ||
+        (uint64_t)header.pageCount * DISK_PAGE_SIZE > (uint64_t)st.st_size || header.freeHead >= header.pageCount) {
+        close();
+        return false;
+    }
+    pageCount = header.pageCount;
+    freeHead = header.freeHead;
+    return true;
+}
+
+/*
+    fetch
+    -----
+    Returns the frame holding page, loading it (load=true) or zero-filling
+    it. When the cache is full the least recently used frame is reused.
+*/
+PageCache::Frame* PageCache::fetch(uint32_t page, bool load) {
+    auto it = lookup.find(page);
+    if (it != lookup.end()) {
+        stats.hits++;
+        frames[it->second].lastUse = ++tick;
+        return &frames[it->second];
+    }
+    if (page >= pageCount) return nullptr;
+
+    size_t idx;
+    if (frames.size() < capacity) {
+        idx = frames.size();
+        frames.push_back(Frame{ 0, false, 0, unique_ptr<char[]>(new char[DISK_PAGE_SIZE]) });
+    } else {
+        idx = 0;
+        for (size_t i = 1; i < frames.size(); i++) {
+            if (frames[i].lastUse < frames[idx].lastUse) idx = i;
+        }
+        if (frames[idx].dirty && !writeBack(frames[idx])) return nullptr;
+        lookup.erase(frames[idx].page);
+    }
+
+    Frame& f = frames[idx];
+    f.page = page;
+    f.dirty = false;
+    f.lastUse = ++tick;
+    if (load) {
+        ssize_t n = ::pread(fd, f.data.get(), DISK_PAGE_SIZE, (off_t)page * DISK_PAGE_SIZE);
+        if (n < 0) return nullptr;
+        // A page allocated but never written back reads short
+        if ((size_t)n < DISK_PAGE_SIZE) memset(f.data.get() + n, 0, DISK_PAGE_SIZE - (size_t)n);
+        stats.reads++;
+    } else {
+        memset(f.data.get(), 0, DISK_PAGE_SIZE);
+    }
+    lookup[page] = idx;
+    return &f;
+}
+
+bool PageCache::writeBack(Frame& f) {
+    const char* p = f.data.get();
+    size_t left = DISK_PAGE_SIZE;
+    off_t pos = (off_t)f.page * DISK_PAGE_SIZE;
+    while (left > 0) {
+        ssize_t n = ::pwrite(fd, p, left, pos);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        pos += n;
+        left -= (size_t)n;
+    }
+    f.dirty = false;
+    stats.writes++;
+    return true;
+}
+
+const char* PageCache::read(uint32_t page) {
+    Frame* f = fetch(page, true);
+    return f ? f->data.get() : nullptr;
+}
+
+char* PageCache::write(uint32_t page) {
+    if (!writable) return nullptr;
+    Frame* f = fetch(page, true);
+    if (!f) return nullptr;
+    f->dirty = true;
+    return f->data.get();
+}
+
+uint32_t PageCache::allocate() {
+    if (!writable) return 0;
+    if (freeHead != 0) {
+        uint32_t page = freeHead;
+        char* p = write(page);
+        if (!p) return 0;
+        memcpy(&freeHead, p, sizeof(freeHead));
+        memset(p, 0, DISK_PAGE_SIZE);
+        return page;
+    }
+    uint32_t page = pageCount++;
+    fetch(page, false)->dirty = true;
+    return page;
+}
+
+void PageCache::release(uint32_t page) {
+    char* p = write(page);
+    if (!p) return;
+    memset(p, 0, DISK_PAGE_SIZE);
+    memcpy(p, &freeHead, sizeof(freeHead));
+    freeHead = page;
+}
+
+// Writes the header fields into page 0, then every dirty frame
+bool PageCache::flush() {
+    if (fd < 0 || !writable) return true;
+
+    PageFileHeader header;
+    memcpy(header.magic, PAGE_FILE_MAGIC, sizeof(header.magic));
+    header.pageSize = DISK_PAGE_SIZE;
+    header.pageCount = pageCount;
+    header.freeHead = freeHead;
+    char* p = write(0);
+    if (!p) return false;
+    memcpy(p, &header, sizeof(header));
+
+    bool ok = true;
+    for (Frame& f : frames) {
+        if (f.dirty) ok = writeBack(f) && ok;
+    }
+    return ok;
+}
+
+void PageCache::close() {
+    if (fd < 0) return;
+    flush();
+    ::close(fd);
+    fd = -1;
+    frames.clear();
+    lookup.clear();
+}
+
+// ===================== NODE ENCODING =====================
+
+size_t DiskBTree::Node::bytes() const {
+    size_t total = sizeof(NodeHeader) + keys.size() * sizeof(Slot);
+    for (const string& k : keys) total += k.size();
+    return total;
+}
+
+static Slot slotAt(const char* page, size_t i) {
+    Slot s;
+    memcpy(&s, page + sizeof(NodeHeader) + i * sizeof(Slot), sizeof(s));
+    return s;
+}
+
+static string_view slotKey(const char* page, const Slot& s) {
+    return string_view(page + s.keyOffset, s.keyLength);
+}
+
+static NodeHeader headerOf(const char* page) {
+    NodeHeader h;
+    memcpy(&h, page, sizeof(h));
+    return h;
+}
+
+void DiskBTree::decode(const char* page, Node& out) {
+    NodeHeader h = headerOf(page);
+    out.leaf = h.leaf != 0;
+    out.next = h.next;
+    out.child0 = h.child0;
+    out.keys.clear();
+    out.values.clear();
+    for (size_t i = 0; i < h.count; i++) {
+        Slot s = slotAt(page, i);
+        out.keys.emplace_back(slotKey(page, s));
+        out.values.push_back(s.value);
+    }
+}
+
+void DiskBTree::encode(const Node& node, char* page) {
+    memset(page, 0, DISK_PAGE_SIZE);
+    NodeHeader h;
+    h.leaf = node.leaf ? 1 : 0;
+    h.pad = 0;
+    h.count = (uint16_t)node.keys.size();
+    h.next = node.next;
+    h.child0 = node.child0;
+    memcpy(page, &h, sizeof(h));
+
+    size_t heap = DISK_PAGE_SIZE;
+    for (size_t i = 0; i < node.keys.size(); i++) {
+        heap -= node.keys[i].size();
+        memcpy(page + heap, node.keys[i].data(), node.keys[i].size());
+        Slot s;
+        s.keyOffset = (uint16_t)heap;
+        s.keyLength = (uint16_t)node.keys[i].size();
+        s.pad = 0;
+        s.value = node.values[i];
+        memcpy(page + sizeof(NodeHeader) + i * sizeof(Slot), &s, sizeof(s));
+    }
+}
+
+// Number of slot keys <= key, i.e. which child of an internal page to follow
+size_t DiskBTree::childSlot(const char* page, string_view key) {
+    size_t lo = 0, hi = headerOf(page).count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (slotKey(page, slotAt(page, mid)) <= key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/*
+    validNode
+    ---------
+    Checks a node page before any of its fields is used: the slot array
+    fits in the page and ends below every key, each key lies inside the
+    page, and every child / sibling id names an existing page other than
+    the header. leaf is what the page must be at its level.
+*/
+static bool validNode(const char* page, bool leaf, uint32_t pageCount) {
+    NodeHeader h = headerOf(page);
+    if (h.leaf > 1 || (h.leaf != 0) != leaf) return false;
+    size_t slotsEnd = sizeof(NodeHeader) + (size_t)h.count * sizeof(Slot);
+    if (slotsEnd > DISK_PAGE_SIZE) return false;
+    if (leaf ? h.next >= pageCount : (h.child0 == 0 || h.child0 >= pageCount)) return false;
+
+    for (size_t i = 0; i < h.count; i++) {
+        Slot s = slotAt(page, i);
+        if (s.keyOffset < slotsEnd || (size_t)s.keyOffset + s.keyLength > DISK_PAGE_SIZE) return false;
+        if (!leaf && (s.value == 0 || s.value >= pageCount)) return false;
+    }
+    return true;
+}
+
+static uint32_t childAt(const char* page, size_t slot) {
+    return (uint32_t)(slot == 0 ? headerOf(page).child0 : slotAt(page, slot - 1).value);
+}
+
+// Split index: the first entries holding about half the bytes, at least one per side
+static size_t splitPoint(const vector<string>& keys, size_t minLeft, size_t maxLeft) {
+    size_t total = 0;
+    for (const string& k : keys) total += k.size() + sizeof(Slot);
+    size_t acc = 0, m = 0;
+    while (m < keys.size() && acc * 2 < total) acc += keys[m++].size() + sizeof(Slot);
+    return min(max(m, minLeft), maxLeft);
+}
+
+// ===================== TREE =====================
+
+DiskBTree::DiskBTree(size_t cachePages)
+    : pages(cachePages), root(0), levels(0), count(0), tag(0), writable(false), damaged(false) {}
+
+DiskBTree::~DiskBTree() {
+    close();
+}
+
+bool DiskBTree::create(const string& path) {
+    close();
+    if (!pages.open(path, true, true)) return false;
+    writable = true;
+    damaged = false;
+    root = pages.allocate();
+    levels = 1;
+    count = 0;
+    tag = 0;
+
+    Node empty;
+    empty.leaf = true;
+    empty.next = 0;
+    empty.child0 = 0;
+    return root != 0 && writeNode(root, empty) && writeMeta();
+}
+
+bool DiskBTree::open(const string& path, bool canWrite) {
+    close();
+    if (!pages.open(path, false, canWrite)) return false;
+
+    const char* p = pages.read(0);
+    TreeMeta meta;
+    if (p) memcpy(&meta, p + PAGE_HEADER_RESERVED, sizeof(meta));
+    if (!p || memcmp(meta.magic, BTREE_MAGIC, sizeof(meta.magic)) != 0 || meta.version != BTREE_VERSION ||
+        meta.root == 0 || meta.root >= pages.size() || meta.levels == 0 || meta.levels >= pages.size()) {
+        pages.close();
+        return false;
+    }
+    root = meta.root;
+    levels = meta.levels;
+    count = meta.count;
+    tag = meta.tag;
+    writable = canWrite;
+    damaged = false;
+    return true;
+}
+
+bool DiskBTree::writeMeta() {
+    char* p = pages.write(0);
+    if (!p) return false;
+    TreeMeta meta;
+    memcpy(meta.magic, BTREE_MAGIC, sizeof(meta.magic));
+    meta.version = BTREE_VERSION;
+    meta.root = root;
+    meta.levels = levels;
+    meta.count = count;
+    meta.tag = tag;
+    memcpy(p + PAGE_HEADER_RESERVED, &meta, sizeof(meta));
+    return true;
+}
+
+bool DiskBTree::close() {
+    if (!pages.isOpen()) return true;
+    bool ok = !writable || writeMeta();
+    ok = pages.flush() && ok;
+    pages.close();
+    writable = false;
+    return ok;
+}
+
+/*
+    readNode / writableNode
+    -----------------------
+    A node page through the cache, checked by validNode(). A page that
+    fails marks the tree damaged and yields nullptr, so no operation
+    ever indexes past a corrupt header or slot.
+*/
+const char* DiskBTree::readNode(uint32_t page, bool leaf) {
+    const char* p = pages.read(page);
+    if (p && !validNode(p, leaf, pages.size())) {
+        damaged = true;
+        return nullptr;
+    }
+    return p;
+}
+
+char* DiskBTree::writableNode(uint32_t page, bool leaf) {
+    return readNode(page, leaf) ? pages.write(page) : nullptr;
+}
+
+bool DiskBTree::writeNode(uint32_t page, const Node& node) {
+    char* p = pages.write(page);
+    if (!p) return false;
+    encode(node, p);
+    return true;
+}
+
+/*
+    leafFor
+    -------
+    Descends to the leaf that holds (or would hold) key. When asked,
+    records every page on the way (leaf last) and the child slot taken
+    in each internal page.
+*/
+uint32_t DiskBTree::leafFor(string_view key, vector<uint32_t>* path, vector<size_t>* slots) {
+    uint32_t page = root;
+    for (uint32_t level = 1; level < levels; level++) {
+        const char* p = readNode(page, false);
+        if (!p) return 0;
+        size_t slot = childSlot(p, key);
+        if (path) path->push_back(page);
+        if (slots) slots->push_back(slot);
+        page = childAt(p, slot);
+    }
+    if (path) path->push_back(page);
+    return page;
+}
+
+bool DiskBTree::find(string_view key, uint64_t& value) {
+    if (!pages.isOpen()) return false;
+    uint32_t leaf = leafFor(key, nullptr, nullptr);
+    const char* p = leaf ? readNode(leaf, true) : nullptr;
+    if (!p) return false;
+
+    size_t n = headerOf(p).count;
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (slotKey(p, slotAt(p, mid)) < key) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == n) return false;
+    Slot s = slotAt(p, lo);
+    if (slotKey(p, s) != key) return false;
+    value = s.value;
+    return true;
+}
+
+/*
+    insert
+    ------
+    Overwrites the value if the key exists. Otherwise adds it to its
+    leaf, in place while the leaf has room; a leaf that no longer fits
+    in a page is split by bytes, the right half's first key goes up as
+    separator (insertSeparator).
+*/
+bool DiskBTree::insert(string_view key, uint64_t value) {
+    if (!writable || key.size() > DISK_BTREE_MAX_KEY) return false;
+
+    vector<uint32_t> path;
+    uint32_t leaf = leafFor(key, &path, nullptr);
+    char* p = leaf ? writableNode(leaf, true) : nullptr;
+    if (!p) return false;
+
+    // Common case in place: overwrite, or add a slot while the page has room
+    NodeHeader h = headerOf(p);
+    size_t i = 0, hi = h.count, heap = DISK_PAGE_SIZE;
+    while (i < hi) {
+        size_t mid = (i + hi) / 2;
+        if (slotKey(p, slotAt(p, mid)) < key) i = mid + 1;
+        else hi = mid;
+    }
+    if (i < h.count) {
+        Slot s = slotAt(p, i);
+        if (slotKey(p, s) == key) {
+            s.value = value;
+            memcpy(p + sizeof(NodeHeader) + i * sizeof(Slot), &s, sizeof(s));
+            return true;
+        }
+    }
+    for (size_t j = 0; j < h.count; j++) heap = min<size_t>(heap, slotAt(p, j).keyOffset);
+    if (sizeof(NodeHeader) + (h.count + 1) * sizeof(Slot) + key.size() <= heap) {
+        char* slots = p + sizeof(NodeHeader);
+        memmove(slots + (i + 1) * sizeof(Slot), slots + i * sizeof(Slot), (h.count - i) * sizeof(Slot));
+        heap -= key.size();
+        memcpy(p + heap, key.data(), key.size());
+        Slot s;
+        s.keyOffset = (uint16_t)heap;
+        s.keyLength = (uint16_t)key.size();
+        s.pad = 0;
+        s.value = value;
+        memcpy(slots + i * sizeof(Slot), &s, sizeof(s));
+        h.count++;
+        memcpy(p, &h, sizeof(h));
+        count++;
+        return true;
+    }
+
+    // Full: encode() below repacks the keys, so space left by erased keys is reclaimed
+    Node n;
+    decode(p, n);
+    n.keys.insert(n.keys.begin() + i, string(key));
+    n.values.insert(n.values.begin() + i, value);
+    count++;
+    if (n.bytes() <= DISK_PAGE_SIZE) return writeNode(leaf, n);
+
+    size_t m = splitPoint(n.keys, 1, n.keys.size() - 1);
+    Node right;
+    right.leaf = true;
+    right.child0 = 0;
+    right.next = n.next;
+    right.keys.assign(n.keys.begin() + m, n.keys.end());
+    right.values.assign(n.values.begin() + m, n.values.end());
+    n.keys.resize(m);
+    n.values.resize(m);
+
+    uint32_t rightPage = pages.allocate();
+    if (rightPage == 0) return false;
+    n.next = rightPage;
+    if (!writeNode(leaf, n) || !writeNode(rightPage, right)) return false;
+
+    path.pop_back();
+    return insertSeparator(path, right.keys[0], rightPage);
+}
+
+/*
+    insertSeparator
+    ---------------
+    Adds (key -> child) to the last page of path. An internal page that
+    overflows is split around a middle key, which moves up one level;
+    splitting the root grows the tree by one level.
+*/
+bool DiskBTree::insertSeparator(vector<uint32_t>& path, string_view key, uint64_t child) {
+    if (path.empty()) {
+        Node r;
+        r.leaf = false;
+        r.next = 0;
+        r.child0 = root;
+        r.keys.emplace_back(key);
+        r.values.push_back(child);
+        uint32_t page = pages.allocate();
+        if (page == 0 || !writeNode(page, r)) return false;
+        root = page;
+        levels++;
+        return true;
+    }
+
+    uint32_t parent = path.back();
+    path.pop_back();
+    const char* p = readNode(parent, false);
+    if (!p) return false;
+
+    Node n;
+    decode(p, n);
+    size_t i = upper_bound(n.keys.begin(), n.keys.end(), key) - n.keys.begin();
+    n.keys.insert(n.keys.begin() + i, string(key));
+    n.values.insert(n.values.begin() + i, child);
+    if (n.bytes() <= DISK_PAGE_SIZE) return writeNode(parent, n);
+
+    size_t m = splitPoint(n.keys, 1, n.keys.size() - 2);
+    string promoted = n.keys[m];
+    Node right;
+    right.leaf = false;
+    right.next = 0;
+    right.child0 = n.values[m];
+    right.keys.assign(n.keys.begin() + m + 1, n.keys.end());
+    right.values.assign(n.values.begin() + m + 1, n.values.end());
+    n.keys.resize(m);
+    n.values.resize(m);
+
+    uint32_t rightPage = pages.allocate();
+    if (rightPage == 0 || !writeNode(parent, n) || !writeNode(rightPage, right)) return false;
+    return insertSeparator(path, promoted, rightPage);
+}
+
+/*
+    bulkLoad
+    --------
+    1. Leaves: entries are appended to the current page until the next
+       one would pass the byte budget; a new page is then started and
+       the finished one, now knowing its right sibling, is written.
+    2. Each finished level yields (first key, page) per page, which is
+       packed the same way into internal pages (the first child of a
+       page goes to child0), until a single page remains: the root.
+    Pages are allocated in key order, so the leaf chain runs forward
+    through the file.
+*/
+bool DiskBTree::bulkLoad(const vector<IndexEntry>& sorted, double fill) {
+    if (!writable || count != 0 || levels != 1) return false;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        if (sorted[i].first.size() > DISK_BTREE_MAX_KEY) return false;
+        if (i > 0 && !(sorted[i - 1].first < sorted[i].first)) return false;
+    }
+
+    // Any page must still take two of the largest entries
+    size_t minBudget = sizeof(NodeHeader) + 2 * (sizeof(Slot) + DISK_BTREE_MAX_KEY);
+    size_t budget = max(minBudget, min(DISK_PAGE_SIZE, (size_t)(fill * DISK_PAGE_SIZE)));
+
+    vector<IndexEntry> level, up;
+    if (!packLevel(sorted, true, budget, level)) return false;
+    count = sorted.size();
+    while (level.size() > 1) {
+        if (!packLevel(level, false, budget, up)) return false;
+        level.swap(up);
+        levels++;
+    }
+    if (!level.empty()) root = (uint32_t)level[0].second;
+    return true;
+}
+
+/*
+    packLevel
+    ---------
+    Writes one level of bulkLoad. items are (key, value) for leaves and
+    (first key, child page) for internal pages; parents receives the
+    (first key, page) of every page written. The first leaf reuses the
+    empty root page left by create().
+*/
+bool DiskBTree::packLevel(const vector<IndexEntry>& items, bool leaf, size_t budget, vector<IndexEntry>& parents) {
+    parents.clear();
+    Node node;
+    uint32_t page = 0;
+    size_t used = 0;
+    for (const IndexEntry& e : items) {
+        size_t need = sizeof(Slot) + e.first.size();
+        if (page != 0 && used + need <= budget) {
+            node.keys.emplace_back(e.first);
+            node.values.push_back(e.second);
+            used += need;
+            continue;
+        }
+
+        uint32_t next = (leaf && parents.empty()) ? root : pages.allocate();
+        if (next == 0) return false;
+        if (page != 0) {
+            node.next = leaf ? next : 0;
+            if (!writeNode(page, node)) return false;
+        }
+        page = next;
+        parents.emplace_back(e.first, page);
+
+        node.leaf = leaf;
+        node.next = 0;
+        node.keys.clear();
+        node.values.clear();
+        if (leaf) {
+            node.child0 = 0;
+            node.keys.emplace_back(e.first);
+            node.values.push_back(e.second);
+            used = sizeof(NodeHeader) + need;
+        } else {
+            node.child0 = e.second;
+            used = sizeof(NodeHeader);
+        }
+    }
+    return page == 0 || writeNode(page, node);
+}
+
+/*
+    erase
+    -----
+    Removes key from its leaf. A leaf left empty (unless it is the root)
+    is taken out of the leaf chain, released to the free-list and
+    unlinked from its parent (unlinkChild).
+*/
+bool DiskBTree::erase(string_view key) {
+    if (!writable) return false;
+
+    vector<uint32_t> path;
+    vector<size_t> slots;
+    uint32_t leaf = leafFor(key, &path, &slots);
+    const char* p = leaf ? readNode(leaf, true) : nullptr;
+    if (!p) return false;
+
+    Node n;
+    decode(p, n);
+    size_t i = lower_bound(n.keys.begin(), n.keys.end(), key) - n.keys.begin();
+    if (i == n.keys.size() || n.keys[i] != key) return false;
+    n.keys.erase(n.keys.begin() + i);
+    n.values.erase(n.values.begin() + i);
+    count--;
+    if (!n.keys.empty() || levels == 1) return writeNode(leaf, n);
+
+    // Predecessor leaf: step left at the deepest level that allows it,
+    // then follow the rightmost children down
+    int level = (int)slots.size() - 1;
+    while (level >= 0 && slots[level] == 0) level--;
+    if (level >= 0) {
+        const char* q = readNode(path[level], false);
+        if (!q) return false;
+        uint32_t page = childAt(q, slots[level] - 1);
+        for (size_t l = level + 1; l < slots.size(); l++) {
+            q = readNode(page, false);
+            if (!q) return false;
+            page = childAt(q, headerOf(q).count);
+        }
+        q = readNode(page, true);
+        if (!q) return false;
+        Node pred;
+        decode(q, pred);
+        pred.next = n.next;
+        if (!writeNode(page, pred)) return false;
+    }
+
+    pages.release(leaf);
+    path.pop_back();
+    return unlinkChild(path, slots);
+}
+
+/*
+    unlinkChild
+    -----------
+    Drops the child at slots.back() from page path.back(). An internal
+    page left without children is released in turn; a root left with a
+    single child is replaced by it (the tree loses a level).
+*/
+bool DiskBTree::unlinkChild(vector<uint32_t>& path, vector<size_t>& slots) {
+    uint32_t page = path.back();
+    size_t slot = slots.back();
+    const char* p = readNode(page, false);
+    if (!p) return false;
+
+    Node n;
+    decode(p, n);
+    if (n.keys.empty()) {
+        // Its only child is gone
+        path.pop_back();
+        slots.pop_back();
+        if (path.empty()) {
+            Node empty;
+            empty.leaf = true;
+            empty.next = 0;
+            empty.child0 = 0;
+            levels = 1;
+            return writeNode(page, empty);
+        }
+        pages.release(page);
+        return unlinkChild(path, slots);
+    }
+
+    if (slot == 0) {
+        n.child0 = n.values[0];
+        n.keys.erase(n.keys.begin());
+        n.values.erase(n.values.begin());
+    } else {
+        n.keys.erase(n.keys.begin() + (slot - 1));
+        n.values.erase(n.values.begin() + (slot - 1));
+    }
+
+    if (page == root && n.keys.empty()) {
+        root = (uint32_t)n.child0;
+        levels--;
+        pages.release(page);
+        return true;
+    }
+    return writeNode(page, n);
+}
+
+// Leftmost leaf, then along the chain; each page is copied before the callback runs.
+// The chain visits at most pageCount() leaves, so a corrupt cycle cannot loop forever.
+void DiskBTree::forEach(const function<void(string_view, uint64_t)>& fn) {
+    if (!pages.isOpen()) return;
+    uint32_t page = root;
+    for (uint32_t level = 1; level < levels && page != 0; level++) {
+        const char* p = readNode(page, false);
+        if (!p) return;
+        page = (uint32_t)headerOf(p).child0;
+    }
+
+    vector<char> copy(DISK_PAGE_SIZE);
+    for (uint32_t visited = 0; page != 0; visited++) {
+        if (visited >= pages.size()) {
+            damaged = true;
+            return;
+        }
+        const char* p = readNode(page, true);
+        if (!p) return;
+        memcpy(copy.data(), p, DISK_PAGE_SIZE);
+        NodeHeader h = headerOf(copy.data());
+        for (size_t i = 0; i < h.count; i++) {
+            Slot s = slotAt(copy.data(), i);
+            fn(slotKey(copy.data(), s), s.value);
+        }
+        page = h.next;
+    }
+}
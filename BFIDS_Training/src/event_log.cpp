@@ -0,0 +1,370 @@
+#include "event_log.h"
+
+#include <iostream>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+    event_log.cpp
+    -------------
+    Binary columnar storage for UserAction records.
+    Records are grouped into blocks; inside a block each field is stored
+    as its own column:
+        - strings are dictionary-encoded (u32 ids into a per-block table)
+        - timestamps are delta-encoded as zigzag varints
+        - durations are stored as raw doubles
+    Logs full of repeated process/action names shrink to a few bytes per
+    event and decode without any text parsing.
+*/
+
+static const char EVENT_LOG_MAGIC[4] = { 'B', 'F', 'E', 'V' };
+
+// Sanity limit so a corrupt length field cannot trigger a huge allocation
+static const uint32_t MAX_BLOCK_RECORDS = 1u << 24;
+static const size_t MAX_VARINT_BYTES = 10;    // A 64-bit varint never needs more
+
+// --- Low-level encoding helpers ---
+
+static void putU32(string& buf, uint32_t v) {
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putVarint(string& buf, uint64_t v) {
+    while (v >= 0x80) {
+        buf.push_back((char)((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    buf.push_back((char)v);
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static bool readU32(ifstream& in, uint32_t& v) {
+    return (bool)in.read(reinterpret_cast<char*>(&v), sizeof(v));
+}
+
+template <typename V>
+static bool readColumn(ifstream& in, vector<V>& col, size_t count) {
+    col.resize(count);
+    return count == 0 || (bool)in.read(reinterpret_cast<char*>(col.data()), sizeof(V) * count);
+}
+
+// ======================= WRITER =======================
+
+EventLogWriter::EventLogWriter(size_t recordsPerBlock)
+    : blockCapacity(recordsPerBlock ? recordsPerBlock : EVENT_LOG_DEFAULT_BLOCK) {}
+
+EventLogWriter::~EventLogWriter() {
+    close();
+}
+
+/*
+    open
+    ----
+    Creates (or truncates) the file and writes the header.
+    In append mode an existing event log is validated and extended instead:
+    anything after the last block that decodes (a block torn by a crash
+    mid-write) is cut off first, otherwise every block appended behind it
+    would be unreachable (the reader stops at the first bad block).
+    A non-empty file that is not an event log is refused, never truncated.
+*/
+bool EventLogWriter::open(const string& filename, bool append) {
+    close();
+    resetBlock();
+
+    struct stat existing;
+    if (append && stat(filename.c_str(), &existing) == 0 && existing.st_size > 0 &&
+        !EventLogReader::isEventLog(filename)) {
+        cerr << "Error: '" << filename << "' is not an event log; refusing to append to it.\n";
+        return false;
+    }
+
+    if (append && EventLogReader::isEventLog(filename)) {
+        uint64_t valid = EventLogReader::validLength(filename);
+        struct stat st;
+        if (stat(filename.c_str(), &st) == 0 && (uint64_t)st.st_size > valid) {
+            if (truncate(filename.c_str(), (off_t)valid) != 0) {
+                cerr << "Error: Could not truncate the damaged tail of event log '" << filename << "'.\n";
+                return false;
+            }
+            cerr << "Warning: Dropped " << ((uint64_t)st.st_size - valid)
+                 << " bytes of a damaged final block from '" << filename << "'.\n";
+        }
+        out.open(filename, ios::binary | ios::app);
+        return out.is_open();
+    }
+
+    out.open(filename, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Error: Could not open event log '" << filename << "' for writing.\n";
+        return false;
+    }
+    out.write(EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC));
+    out.write(reinterpret_cast<const char*>(&EVENT_LOG_VERSION), sizeof(EVENT_LOG_VERSION));
+    return (bool)out;
+}
+
+/*
+    intern
+    ------
+    Returns the dictionary id of a string within the pending block.
+*/
+uint32_t EventLogWriter::intern(const string& s) {
+    auto it = dictIndex.find(s);
+    if (it != dictIndex.end()) return it->second;
+
+    uint32_t id = (uint32_t)dict.size();
+    dict.push_back(s);
+    dictIndex.emplace(s, id);
+    return id;
+}
+
+void EventLogWriter::resetBlock() {
+    dictIndex.clear();
+    dict.clear();
+    userIDs.clear();
+    actions.clear();
+    processes.clear();
+    nextActions.clear();
+    statuses.clear();
+    timestamps.clear();
+    durations.clear();
+}
+
+/*
+    append
+    ------
+    Splits the action into its columns. Full blocks are written out immediately.
+*/
+bool EventLogWriter::append(const UserAction& action) {
+    if (!out.is_open()) return false;
+
+    userIDs.push_back(intern(action.userID));
+    actions.push_back(intern(action.action));
+    processes.push_back(intern(action.processName));
+    nextActions.push_back(intern(action.nextAction));
+    statuses.push_back(intern(action.status));
+    timestamps.push_back((int64_t)action.timestamp);
+    durations.push_back(action.duration);
+
+    if (durations.size() >= blockCapacity) return flush();
+    return true;
+}
+
+/*
+    flush
+    -----
+    Encodes the pending records as one block and writes it in a single call.
+*/
+bool EventLogWriter::flush() {
+    if (!out.is_open()) return false;
+    if (durations.empty()) return true;
+
+    uint32_t count = (uint32_t)durations.size();
+    string buf;
+    buf.reserve(count * (5 * sizeof(uint32_t) + sizeof(double) + 3) + dict.size() * 16);
+
+    putU32(buf, count);
+    putU32(buf, (uint32_t)dict.size());
+    for (const string& s : dict) {
+        putU32(buf, (uint32_t)s.size());
+        buf.append(s);
+    }
+
+    const vector<uint32_t>* idColumns[] = { &userIDs, &actions, &processes, &nextActions, &statuses };
+    for (const vector<uint32_t>* col : idColumns) {
+        buf.append(reinterpret_cast<const char*>(col->data()), col->size() * sizeof(uint32_t));
+    }
+
+    // Timestamps: first value verbatim, the rest as deltas from their predecessor
+    string ts;
+    ts.append(reinterpret_cast<const char*>(&timestamps[0]), sizeof(int64_t));
+    for (size_t i = 1; i < timestamps.size(); i++) {
+        putVarint(ts, zigzag(timestamps[i] - timestamps[i - 1]));
+    }
+    putU32(buf, (uint32_t)ts.size());
+    buf.append(ts);
+
+    buf.append(reinterpret_cast<const char*>(durations.data()), durations.size() * sizeof(double));
+
+    out.write(buf.data(), (streamsize)buf.size());
+    out.flush();
+    resetBlock();
+    return (bool)out;
+}
+
+bool EventLogWriter::close() {
+    if (!out.is_open()) return true;
+    bool ok = flush();
+    out.close();
+    return ok;
+}
+
+// ======================= READER =======================
+
+EventLogReader::EventLogReader() : blockSize(0), cursor(0), damaged(false), fileSize(0) {}
+
+/*
+    isEventLog
+    ----------
+    Checks the magic bytes and version without reading any records.
+*/
+bool EventLogReader::isEventLog(const string& filename) {
+    ifstream f(filename, ios::binary);
+    if (!f.is_open()) return false;
+
+    char magic[4];
+    uint32_t version = 0;
+    if (!f.read(magic, sizeof(magic)) || !readU32(f, version)) return false;
+    return memcmp(magic, EVENT_LOG_MAGIC, sizeof(magic)) == 0 && version == EVENT_LOG_VERSION;
+}
+
+/*
+    validLength
+    -----------
+    Byte length of the readable prefix: the header plus every block up to
+    the first truncated or corrupt one.
+*/
+uint64_t EventLogReader::validLength(const string& filename) {
+    EventLogReader reader;
+    if (!reader.open(filename)) return 0;
+    uint64_t valid = (uint64_t)reader.in.tellg();
+    while (reader.loadBlock()) valid = (uint64_t)reader.in.tellg();
+    return valid;
+}
+
+bool EventLogReader::open(const string& filename) {
+    close();
+    if (!isEventLog(filename)) return false;
+
+    in.open(filename, ios::binary);
+    if (!in.is_open()) return false;
+    in.seekg(0, ios::end);
+    fileSize = (uint64_t)in.tellg();
+    in.seekg(sizeof(EVENT_LOG_MAGIC) + sizeof(uint32_t));
+    return true;
+}
+
+void EventLogReader::close() {
+    if (in.is_open()) in.close();
+    blockSize = cursor = 0;
+    damaged = false;
+}
+
+/*
+    loadBlock
+    ---------
+    Decodes the next block into the column buffers.
+    Returns false at end of file or if the block is truncated/corrupt;
+    only the latter sets damaged.
+    Every length read from the file is checked against the bytes left in
+    it before anything is allocated, so a corrupt field cannot request
+    more memory than the file could fill.
+*/
+bool EventLogReader::loadBlock() {
+    blockSize = cursor = 0;
+    if (in.peek() == char_traits<char>::eof()) return false;
+    damaged = true;
+
+    streamoff at = in.tellg();
+    if (at < 0 || (uint64_t)at > fileSize) return false;
+    uint64_t left = fileSize - (uint64_t)at;
+
+    // Fixed part per record: five id columns and the duration
+    const uint64_t recordBytes = 5 * sizeof(uint32_t) + sizeof(double);
+    uint32_t count = 0, dictSize = 0;
+    if (!readU32(in, count) || !readU32(in, dictSize)) return false;
+    if (count == 0 || count > MAX_BLOCK_RECORDS || dictSize > 5 * count) return false;
+    left -= min<uint64_t>(left, 2 * sizeof(uint32_t));
+    if ((uint64_t)count * recordBytes + (uint64_t)dictSize * sizeof(uint32_t) > left) return false;
+
+    dict.resize(dictSize);
+    for (uint32_t i = 0; i < dictSize; i++) {
+        uint32_t len = 0;
+        if (left < sizeof(uint32_t) || !readU32(in, len) || len > left - sizeof(uint32_t)) return false;
+        left -= sizeof(uint32_t) + len;
+        dict[i].resize(len);
+        if (len && !in.read(&dict[i][0], len)) return false;
+    }
+    if ((uint64_t)count * recordBytes + sizeof(uint32_t) > left) return false;
+    left -= (uint64_t)count * recordBytes + sizeof(uint32_t);
+
+    if (!readColumn(in, userIDs, count) || !readColumn(in, actions, count) ||
+        !readColumn(in, processes, count) || !readColumn(in, nextActions, count) ||
+        !readColumn(in, statuses, count)) return false;
+
+    uint32_t tsBytes = 0;
+    if (!readU32(in, tsBytes) || tsBytes < sizeof(int64_t) || tsBytes > left ||
+        tsBytes > sizeof(int64_t) + (uint64_t)(count - 1) * MAX_VARINT_BYTES) return false;
+    string ts(tsBytes, '\0');
+    if (!in.read(&ts[0], tsBytes)) return false;
+
+    timestamps.resize(count);
+    memcpy(&timestamps[0], ts.data(), sizeof(int64_t));
+    size_t pos = sizeof(int64_t);
+    for (uint32_t i = 1; i < count; i++) {
+        uint64_t v = 0;
+        int shift = 0;
+        while (true) {
+            if (pos >= ts.size() || shift > 63) return false;
+            unsigned char b = (unsigned char)ts[pos++];
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+            shift += 7;
+        }
+        timestamps[i] = timestamps[i - 1] + unzigzag(v);
+    }
+
+    if (!readColumn(in, durations, count)) return false;
+
+    // Every id must point into this block's dictionary
+    const vector<uint32_t>* idColumns[] = { &userIDs, &actions, &processes, &nextActions, &statuses };
+    for (const vector<uint32_t>* col : idColumns) {
+        for (uint32_t id : *col) {
+            if (id >= dictSize) return false;
+        }
+    }
+
+    blockSize = count;
+    damaged = false;
+    return true;
+}
+
+/*
+    next
+    ----
+    Materializes the next record as a UserAction.
+*/
+bool EventLogReader::next(UserAction& out) {
+    if (!in.is_open()) return false;
+    if (cursor >= blockSize && !loadBlock()) return false;
+
+    size_t i = cursor++;
+    out.userID = dict[userIDs[i]];
+    out.action = dict[actions[i]];
+    out.processName = dict[processes[i]];
+    out.nextAction = dict[nextActions[i]];
+    out.status = dict[statuses[i]];
+    out.timestamp = (time_t)timestamps[i];
+    out.duration = durations[i];
+    return true;
+}
+
+size_t EventLogReader::readAll(LinkedList& list) {
+    size_t n = 0;
+    UserAction ua;
+    while (next(ua)) {
+        list.insertAtEnd(ua);
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,88 @@
+#include "event_table.h"
+#include "sorting_algorithms.h"
+
+using namespace std;
+
+/*
+    event_table.cpp
+    ---------------
+    Structure-of-Arrays event storage.
+    An array-of-structs UserAction drags ~176 bytes through the cache to
+    read one 8-byte field; here a timestamp sort touches 8 bytes per event
+    and a (process, duration) aggregation touches 12.
+*/
+
+void EventTable::reserve(size_t rows) {
+    timestamps.reserve(rows);
+    durations.reserve(rows);
+    userIDs.reserve(rows);
+    actions.reserve(rows);
+    processes.reserve(rows);
+    nextActions.reserve(rows);
+    statuses.reserve(rows);
+}
+
+void EventTable::append(const CompactAction& a) {
+    timestamps.push_back(a.timestamp);
+    durations.push_back(a.duration);
+    userIDs.push_back(a.userID);
+    actions.push_back(a.action);
+    processes.push_back(a.processName);
+    nextActions.push_back(a.nextAction);
+    statuses.push_back(a.status);
+}
+
+void EventTable::append(const ActionFields& fields) {
+    append(symbols.encode(fields));
+}
+
+void EventTable::append(const UserAction& action) {
+    append(symbols.encode(action));
+}
+
+/*
+    sortedByTimestamp
+    -----------------
+    Radix argsort of the timestamp column; rows themselves are not moved.
+*/
+vector<uint32_t> EventTable::sortedByTimestamp() const {
+    vector<uint32_t> order(size());
+    SortingAlgorithms::radixArgsort(timestamps.data(), order.data(), size());
+    return order;
+}
+
+/*
+    aggregateByProcess
+    ------------------
+    One sequential pass over the process and duration columns.
+    Symbol ids are dense, so plain arrays replace any hashing or tree walk.
+*/
+void EventTable::aggregateByProcess(vector<DurationSum>& out) const {
+    out.assign(symbols.size(), DurationSum());
+
+    const SymbolID* proc = processes.data();
+    const double* dur = durations.data();
+    size_t n = size();
+    for (size_t i = 0; i < n; i++) {
+        out[proc[i]].add(dur[i]);
+    }
+}
+
+CompactAction EventTable::row(size_t i) const {
+    CompactAction c;
+    c.timestamp = timestamps[i];
+    c.duration = durations[i];
+    c.userID = userIDs[i];
+    c.action = actions[i];
+    c.processName = processes[i];
+    c.nextAction = nextActions[i];
+    c.status = statuses[i];
+    return c;
+}
+
+size_t EventTable::memoryUsage() const {
+    size_t bytes = timestamps.capacity() * sizeof(time_t) + durations.capacity() * sizeof(double);
+    bytes += (userIDs.capacity() + actions.capacity() + processes.capacity() +
+              nextActions.capacity() + statuses.capacity()) * sizeof(SymbolID);
+    return bytes + symbols.memoryUsage();
+}
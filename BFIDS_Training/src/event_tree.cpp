@@ -0,0 +1,496 @@
+#include "event_tree.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+/*
+    event_tree.cpp
+    --------------
+    B+Tree over (timestamp, sequence) with the records in the leaves.
+    A time-window query costs one root-to-leaf descent plus the leaves
+    that actually hold the window; the rest of the store is never read.
+
+    Key DSA Concepts:
+        - B+Tree (separators in internal nodes, data in linked leaves)
+        - Node split / merge / redistribution
+        - Free-list reuse of pooled nodes
+*/
+
+EventTree::EventTree() : root(NIL), levels(1), count(0), leafCount(0), nextSequence(0) {
+    root = newLeaf();
+}
+
+// ===================== NODE POOLS =====================
+
+uint32_t EventTree::newLeaf() {
+    uint32_t id;
+    if (!freeLeaves.empty()) {
+        id = freeLeaves.back();
+        freeLeaves.pop_back();
+    } else {
+        id = (uint32_t)leaves.size();
+        leaves.emplace_back();
+    }
+    Leaf& l = leaves[id];
+    l.prev = NIL;
+    l.next = NIL;
+    l.n = 0;
+    leafCount++;
+    return id;
+}
+
+uint32_t EventTree::newInner() {
+    uint32_t id;
+    if (!freeInners.empty()) {
+        id = freeInners.back();
+        freeInners.pop_back();
+    } else {
+        id = (uint32_t)inners.size();
+        inners.emplace_back();
+    }
+    inners[id].n = 0;
+    return id;
+}
+
+void EventTree::freeLeaf(uint32_t id) {
+    freeLeaves.push_back(id);
+    leafCount--;
+}
+
+void EventTree::freeInner(uint32_t id) {
+    freeInners.push_back(id);
+}
+
+void EventTree::clear() {
+    leaves.clear();
+    inners.clear();
+    freeLeaves.clear();
+    freeInners.clear();
+    count = 0;
+    leafCount = 0;
+    levels = 1;
+    root = newLeaf();
+}
+
+size_t EventTree::memoryUsage() const {
+    return leaves.size() * sizeof(Leaf) + inners.size() * sizeof(Inner) +
+           (freeLeaves.capacity() + freeInners.capacity()) * sizeof(uint32_t) + symbols.memoryUsage();
+}
+
+// ===================== SEARCH =====================
+
+// First slot whose key is >= k
+int EventTree::lowerBound(const Leaf& leaf, const EventKey& k) {
+    return (int)(std::lower_bound(leaf.keys, leaf.keys + leaf.n, k) - leaf.keys);
+}
+
+// Number of separators <= k, i.e. the child to follow
+int EventTree::childSlot(const Inner& node, const EventKey& k) {
+    return (int)(std::upper_bound(node.keys, node.keys + node.n, k) - node.keys);
+}
+
+/*
+    descend
+    -------
+    Walks from the root to the leaf where k is or would be. When asked,
+    records every internal node on the way and the child slot taken.
+*/
+uint32_t EventTree::descend(const EventKey& k, vector<uint32_t>* path, vector<int>* slots,
+                            EventScanStats* stats) const {
+    uint32_t x = root;
+    for (int level = 1; level < levels; level++) {
+        const Inner& node = inners[x];
+        int s = childSlot(node, k);
+        if (path) path->push_back(x);
+        if (slots) slots->push_back(s);
+        if (stats) stats->innerVisited++;
+        x = node.children[s];
+    }
+    return x;
+}
+
+/*
+    scan
+    ----
+    One descent to the first key >= (t1, 0), then leaf to leaf until a
+    timestamp reaches t2.
+*/
+size_t EventTree::scan(time_t t1, time_t t2, const function<void(const EventKey&, const CompactAction&)>& fn,
+                       EventScanStats* stats) const {
+    if (t1 >= t2) return 0;
+    EventKey from{ (int64_t)t1, 0 };
+    uint32_t leaf = descend(from, nullptr, nullptr, stats);
+    int pos = lowerBound(leaves[leaf], from);
+
+    size_t matched = 0;
+    while (leaf != NIL) {
+        const Leaf& l = leaves[leaf];
+        if (stats) stats->leavesVisited++;
+        for (int i = pos; i < l.n; i++) {
+            if (l.keys[i].timestamp >= (int64_t)t2) {
+                if (stats) stats->matched += matched;
+                return matched;
+            }
+            fn(l.keys[i], l.records[i]);
+            matched++;
+        }
+        leaf = l.next;
+        pos = 0;
+    }
+    if (stats) stats->matched += matched;
+    return matched;
+}
+
+void EventTree::forEach(const function<void(const EventKey&, const CompactAction&)>& fn) const {
+    uint32_t x = root;
+    for (int level = 1; level < levels; level++) x = inners[x].children[0];
+    for (; x != NIL; x = leaves[x].next) {
+        const Leaf& l = leaves[x];
+        for (int i = 0; i < l.n; i++) fn(l.keys[i], l.records[i]);
+    }
+}
+
+// ===================== INSERT =====================
+
+EventKey EventTree::insert(const CompactAction& action) {
+    EventKey k{ (int64_t)action.timestamp, nextSequence++ };
+    insertKey(k, action);
+    return k;
+}
+
+EventKey EventTree::insert(const UserAction& action) {
+    return insert(symbols.encode(action));
+}
+
+EventKey EventTree::insert(const ActionFields& fields) {
+    return insert(symbols.encode(fields));
+}
+
+/*
+    insertKey
+    ---------
+    Places the entry in its leaf. A full leaf is split: normally in half,
+    but when the entry goes past the last key of the rightmost leaf (the
+    usual case for a log) the old leaf stays full and the new leaf starts
+    with just this entry.
+*/
+void EventTree::insertKey(const EventKey& k, const CompactAction& record) {
+    vector<uint32_t>& path = pathScratch;
+    vector<int>& slots = slotScratch;
+    path.clear();
+    slots.clear();
+    uint32_t leaf = descend(k, &path, &slots);
+    Leaf& l = leaves[leaf];
+    int pos = lowerBound(l, k);
+    count++;
+
+    if (l.n < EVENT_LEAF_MAX) {
+        for (int j = l.n; j > pos; j--) {
+            l.keys[j] = l.keys[j - 1];
+            l.records[j] = l.records[j - 1];
+        }
+        l.keys[pos] = k;
+        l.records[pos] = record;
+        l.n++;
+        return;
+    }
+
+    bool atEnd = pos == l.n && l.next == NIL;
+    int keep = atEnd ? EVENT_LEAF_MAX : (EVENT_LEAF_MAX + 1) / 2;   // Entries left of the split, new one included
+
+    uint32_t rightId = newLeaf();
+    Leaf& r = leaves[rightId];
+    // The new entry lands left of the split point when pos < keep
+    int moveFrom = (pos < keep) ? keep - 1 : keep;
+    r.n = l.n - moveFrom;
+    copy(l.keys + moveFrom, l.keys + l.n, r.keys);
+    copy(l.records + moveFrom, l.records + l.n, r.records);
+    l.n = moveFrom;
+
+    Leaf& target = (pos < keep) ? l : r;
+    int at = (pos < keep) ? pos : pos - keep;
+    for (int j = target.n; j > at; j--) {
+        target.keys[j] = target.keys[j - 1];
+        target.records[j] = target.records[j - 1];
+    }
+    target.keys[at] = k;
+    target.records[at] = record;
+    target.n++;
+
+    r.prev = leaf;
+    r.next = l.next;
+    if (l.next != NIL) leaves[l.next].prev = rightId;
+    l.next = rightId;
+
+    insertIntoParent(path, slots, r.keys[0], rightId, atEnd);
+}
+
+/*
+    insertIntoParent
+    ----------------
+    Adds (separator -> right) next to the child just split, walking up
+    while parents are full. A full internal node is split around a
+    middle separator, which moves up; splitting the root adds a level.
+*/
+void EventTree::insertIntoParent(vector<uint32_t>& path, vector<int>& slots, EventKey separator,
+                                 uint32_t right, bool atEnd) {
+    while (!path.empty()) {
+        uint32_t p = path.back();
+        int s = slots.back();
+        path.pop_back();
+        slots.pop_back();
+        Inner& node = inners[p];
+        atEnd = atEnd && s == node.n;
+
+        if (node.n < EVENT_INNER_MAX) {
+            for (int j = node.n; j > s; j--) node.keys[j] = node.keys[j - 1];
+            for (int j = node.n + 1; j > s + 1; j--) node.children[j] = node.children[j - 1];
+            node.keys[s] = separator;
+            node.children[s + 1] = right;
+            node.n++;
+            return;
+        }
+
+        // Combined view: EVENT_INNER_MAX + 1 separators, one more child
+        EventKey keys[EVENT_INNER_MAX + 1];
+        uint32_t children[EVENT_INNER_MAX + 2];
+        copy(node.keys, node.keys + s, keys);
+        keys[s] = separator;
+        copy(node.keys + s, node.keys + node.n, keys + s + 1);
+        copy(node.children, node.children + s + 1, children);
+        children[s + 1] = right;
+        copy(node.children + s + 1, node.children + node.n + 1, children + s + 2);
+
+        int mid = atEnd ? EVENT_INNER_MAX - 1 : EVENT_INNER_MAX / 2;
+        uint32_t q = newInner();
+        Inner& other = inners[q];
+        node.n = mid;
+        copy(keys, keys + mid, node.keys);
+        copy(children, children + mid + 1, node.children);
+        other.n = EVENT_INNER_MAX - mid;
+        copy(keys + mid + 1, keys + EVENT_INNER_MAX + 1, other.keys);
+        copy(children + mid + 1, children + EVENT_INNER_MAX + 2, other.children);
+
+        separator = keys[mid];
+        right = q;
+    }
+
+    uint32_t top = newInner();
+    Inner& r = inners[top];
+    r.n = 1;
+    r.keys[0] = separator;
+    r.children[0] = root;
+    r.children[1] = right;
+    root = top;
+    levels++;
+}
+
+// ===================== DELETE =====================
+
+// Drops child slot and the separator that bounded it
+void EventTree::removeChild(Inner& node, int slot) {
+    int key = (slot > 0) ? slot - 1 : 0;
+    for (int j = key; j < node.n - 1; j++) node.keys[j] = node.keys[j + 1];
+    for (int j = slot; j < node.n; j++) node.children[j] = node.children[j + 1];
+    node.n--;
+}
+
+/*
+    fixLeaf
+    -------
+    Restores the minimum fill of a leaf after removals.
+    - Empty: unlinked from the leaf chain and its parent, then freed.
+    - Underfull: merged with a sibling when both fit in one leaf,
+      otherwise the two share their entries evenly (redistribution).
+    A merge or unlink removes a child from the parent, which may then
+    need fixing in turn (fixInner).
+*/
+void EventTree::fixLeaf(vector<uint32_t>& path, vector<int>& slots, uint32_t leaf) {
+    Leaf& l = leaves[leaf];
+    if (path.empty() || l.n >= EVENT_LEAF_MIN) return;
+
+    Inner& parent = inners[path.back()];
+    int s = slots.back();
+
+    if (l.n == 0) {
+        if (l.prev != NIL) leaves[l.prev].next = l.next;
+        if (l.next != NIL) leaves[l.next].prev = l.prev;
+        removeChild(parent, s);
+        freeLeaf(leaf);
+        fixInner(path, slots);
+        return;
+    }
+
+    // Pair the leaf with a neighbour under the same parent: (a, b) = (left, right)
+    int sep = (s > 0) ? s - 1 : 0;
+    uint32_t aId = parent.children[sep], bId = parent.children[sep + 1];
+    Leaf& a = leaves[aId];
+    Leaf& b = leaves[bId];
+
+    if (a.n + b.n <= EVENT_LEAF_MAX) {
+        copy(b.keys, b.keys + b.n, a.keys + a.n);
+        copy(b.records, b.records + b.n, a.records + a.n);
+        a.n += b.n;
+        a.next = b.next;
+        if (b.next != NIL) leaves[b.next].prev = aId;
+        removeChild(parent, sep + 1);
+        freeLeaf(bId);
+        fixInner(path, slots);
+        return;
+    }
+
+    int total = a.n + b.n;
+    int leftCount = total / 2;
+    if (a.n > leftCount) {
+        int move = a.n - leftCount;
+        copy_backward(b.keys, b.keys + b.n, b.keys + b.n + move);
+        copy_backward(b.records, b.records + b.n, b.records + b.n + move);
+        copy(a.keys + leftCount, a.keys + a.n, b.keys);
+        copy(a.records + leftCount, a.records + a.n, b.records);
+    } else {
+        int move = leftCount - a.n;
+        copy(b.keys, b.keys + move, a.keys + a.n);
+        copy(b.records, b.records + move, a.records + a.n);
+        copy(b.keys + move, b.keys + b.n, b.keys);
+        copy(b.records + move, b.records + b.n, b.records);
+    }
+    b.n = total - leftCount;
+    a.n = leftCount;
+    parent.keys[sep] = b.keys[0];
+}
+
+/*
+    fixInner
+    --------
+    Same for the internal node at the end of path, then upwards while
+    merges keep removing children. Merging pulls the parent's separator
+    down between the two halves; redistribution rotates keys through it.
+    A root left with a single child is replaced by that child.
+*/
+void EventTree::fixInner(vector<uint32_t>& path, vector<int>& slots) {
+    while (!path.empty()) {
+        uint32_t x = path.back();
+        path.pop_back();
+        slots.pop_back();
+        Inner& node = inners[x];
+
+        if (path.empty()) {
+            if (node.n == 0) {
+                root = node.children[0];
+                levels--;
+                freeInner(x);
+            }
+            return;
+        }
+        if (node.n >= EVENT_INNER_MIN) return;
+
+        Inner& parent = inners[path.back()];
+        int s = slots.back();
+        int sep = (s > 0) ? s - 1 : 0;
+        uint32_t aId = parent.children[sep], bId = parent.children[sep + 1];
+        Inner& a = inners[aId];
+        Inner& b = inners[bId];
+
+        if (a.n + b.n + 1 <= EVENT_INNER_MAX) {
+            a.keys[a.n] = parent.keys[sep];
+            copy(b.keys, b.keys + b.n, a.keys + a.n + 1);
+            copy(b.children, b.children + b.n + 1, a.children + a.n + 1);
+            a.n += b.n + 1;
+            removeChild(parent, sep + 1);
+            freeInner(bId);
+            continue;
+        }
+
+        // Combined view: a's keys, the separator, b's keys
+        EventKey keys[2 * EVENT_INNER_MAX + 1];
+        uint32_t children[2 * EVENT_INNER_MAX + 2];
+        int total = a.n + b.n + 1;
+        copy(a.keys, a.keys + a.n, keys);
+        keys[a.n] = parent.keys[sep];
+        copy(b.keys, b.keys + b.n, keys + a.n + 1);
+        copy(a.children, a.children + a.n + 1, children);
+        copy(b.children, b.children + b.n + 1, children + a.n + 1);
+
+        int leftCount = total / 2;
+        a.n = leftCount;
+        copy(keys, keys + leftCount, a.keys);
+        copy(children, children + leftCount + 1, a.children);
+        parent.keys[sep] = keys[leftCount];
+        b.n = total - leftCount - 1;
+        copy(keys + leftCount + 1, keys + total, b.keys);
+        copy(children + leftCount + 1, children + total + 1, b.children);
+        return;
+    }
+}
+
+bool EventTree::erase(const EventKey& key) {
+    vector<uint32_t>& path = pathScratch;
+    vector<int>& slots = slotScratch;
+    path.clear();
+    slots.clear();
+    uint32_t leaf = descend(key, &path, &slots);
+    Leaf& l = leaves[leaf];
+    int pos = lowerBound(l, key);
+    if (pos == l.n || !(l.keys[pos] == key)) return false;
+
+    for (int j = pos; j < l.n - 1; j++) {
+        l.keys[j] = l.keys[j + 1];
+        l.records[j] = l.records[j + 1];
+    }
+    l.n--;
+    count--;
+    fixLeaf(path, slots, leaf);
+    return true;
+}
+
+/*
+    eraseRange
+    ----------
+    Repeats: descend to the first key still in [t1, t2), cut the whole
+    run of matching entries out of that leaf at once, fix the leaf.
+    A leaf whose entries all match is simply unlinked, so deleting k
+    events costs about k / EVENT_LEAF_MAX descents rather than k.
+*/
+size_t EventTree::eraseRange(time_t t1, time_t t2) {
+    if (t1 >= t2) return 0;
+    size_t removed = 0;
+    EventKey from{ (int64_t)t1, 0 };
+
+    vector<uint32_t>& path = pathScratch;
+    vector<int>& slots = slotScratch;
+    while (true) {
+        path.clear();
+        slots.clear();
+        uint32_t leaf = descend(from, &path, &slots);
+        Leaf& l = leaves[leaf];
+        int pos = lowerBound(l, from);
+
+        if (pos == l.n) {
+            // Everything here is older; the range may start in the next leaf
+            if (l.next == NIL || leaves[l.next].keys[0].timestamp >= (int64_t)t2) break;
+            from = leaves[l.next].keys[0];
+            continue;
+        }
+
+        int end = pos;
+        while (end < l.n && l.keys[end].timestamp < (int64_t)t2) end++;
+        if (end == pos) break;
+
+        int oldCount = l.n;
+        copy(l.keys + end, l.keys + l.n, l.keys + pos);
+        copy(l.records + end, l.records + l.n, l.records + pos);
+        l.n -= end - pos;
+        count -= end - pos;
+        removed += end - pos;
+        fixLeaf(path, slots, leaf);
+
+        if (end < oldCount) break;      // Reached a key >= t2
+    }
+    return removed;
+}
+
+size_t EventTree::eraseBefore(time_t cutoff) {
+    return eraseRange(numeric_limits<time_t>::min(), cutoff);
+}
@@ -0,0 +1,240 @@
+#include "external_sort.h"
+#include "event_log.h"
+
+#include <iostream>
+#include <algorithm>
+#include <queue>
+#include <memory>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+    external_sort.cpp
+    -----------------
+    External Merge Sort for UserActions.
+    Phase 1 (Run generation): fill a buffer up to the memory budget,
+        stable-sort it by timestamp and write it to a temporary file.
+    Phase 2 (k-way merge): open up to SORT_MERGE_FAN_IN runs and repeatedly
+        emit the smallest head using a Min-Heap keyed by (timestamp, run
+        index). More runs than that are first merged into longer runs,
+        oldest first, so the final pass never has more than the fan-in open.
+    Memory use is bounded by the budget: while merging, the open readers
+    and the run being written each hold one block of about
+    budget / (SORT_MERGE_FAN_IN + 1) bytes.
+
+    DSA Concepts:
+        - Divide & Conquer (sorted runs + merge)
+        - Priority Queue / Min-Heap (k-way merge)
+*/
+
+static bool byTimestamp(const UserAction& a, const UserAction& b) {
+    return a.timestamp < b.timestamp;
+}
+
+ExternalActionSorter::ExternalActionSorter(size_t memoryBytes)
+    : memoryBudget(memoryBytes ? memoryBytes : 1), bufferedBytes(0), addedBytes(0), addedCount(0) {
+    const char* tmp = getenv("TMPDIR");
+    tempDir = (tmp && *tmp) ? tmp : "/tmp";
+}
+
+ExternalActionSorter::~ExternalActionSorter() {
+    removeRuns();
+}
+
+/*
+    estimateBytes
+    -------------
+    sizeof(UserAction) plus the heap blocks of strings too long for SSO.
+*/
+size_t ExternalActionSorter::estimateBytes(const UserAction& action) {
+    const string* fields[] = { &action.userID, &action.action, &action.processName,
+                               &action.nextAction, &action.status };
+    size_t bytes = sizeof(UserAction);
+    for (const string* s : fields) {
+        if (s->capacity() > 15) bytes += s->capacity() + 1;
+    }
+    return bytes;
+}
+
+void ExternalActionSorter::removeRuns() {
+    for (const string& f : runFiles) unlink(f.c_str());
+    runFiles.clear();
+    runCounts.clear();
+}
+
+/*
+    add
+    ---
+    Buffers the action and spills a sorted run once the budget is used up.
+*/
+bool ExternalActionSorter::add(const UserAction& action) {
+    size_t bytes = estimateBytes(action);
+    bufferedBytes += bytes;
+    addedBytes += bytes;
+    addedCount++;
+    buffer.push_back(action);
+
+    if (bufferedBytes >= memoryBudget) return spillRun();
+    return true;
+}
+
+/*
+    runBlockRecords
+    ---------------
+    Records per run block, so that a full merge pass (SORT_MERGE_FAN_IN
+    readers plus one writer, one decoded block each) fits the budget.
+    A decoded record costs about what it did buffered (estimateBytes).
+*/
+size_t ExternalActionSorter::runBlockRecords() const {
+    size_t perRecord = addedCount ? max<size_t>(addedBytes / addedCount, 1) : sizeof(UserAction);
+    size_t records = memoryBudget / ((SORT_MERGE_FAN_IN + 1) * perRecord);
+    return min(max<size_t>(records, 1), EVENT_LOG_DEFAULT_BLOCK);
+}
+
+bool ExternalActionSorter::newRunFile(string& path) {
+    path = tempDir + "/bfids_sortrun_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        cerr << "Error: Could not create a temporary sort run in '" << tempDir << "'.\n";
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+/*
+    spillRun
+    --------
+    Sorts the buffer and writes it to a fresh temporary event log.
+*/
+bool ExternalActionSorter::spillRun() {
+    if (buffer.empty()) return true;
+
+    stable_sort(buffer.begin(), buffer.end(), byTimestamp);
+
+    string pattern;
+    if (!newRunFile(pattern)) return false;
+    runFiles.push_back(pattern);
+    runCounts.push_back(0);
+
+    EventLogWriter writer(runBlockRecords());
+    if (!writer.open(pattern)) return false;
+    for (const UserAction& a : buffer) {
+        if (!writer.append(a)) return false;
+    }
+    if (!writer.close()) return false;
+    runCounts.back() = buffer.size();
+
+    buffer.clear();
+    buffer.shrink_to_fit();
+    bufferedBytes = 0;
+    return true;
+}
+
+/*
+    mergeRuns
+    ---------
+    k-way merge of runFiles[first, first + count) through a Min-Heap,
+    handing each action to fn in timestamp order. Fails if a run ends
+    early (damaged block) or yields another number of records than
+    runCounts says was written.
+*/
+bool ExternalActionSorter::mergeRuns(size_t first, size_t count, const function<void(const UserAction&)>& fn) {
+    vector<unique_ptr<EventLogReader>> readers(count);
+    vector<UserAction> heads(count);
+    vector<size_t> read(count, 0);
+
+    // (timestamp, run) -- the run index breaks ties so the merge stays stable
+    typedef pair<time_t, size_t> HeapEntry;
+    priority_queue<HeapEntry, vector<HeapEntry>, greater<HeapEntry>> heap;
+
+    for (size_t r = 0; r < count; r++) {
+        readers[r].reset(new EventLogReader());
+        if (!readers[r]->open(runFiles[first + r])) {
+            cerr << "Error: Could not reopen sort run '" << runFiles[first + r] << "'.\n";
+            return false;
+        }
+        if (readers[r]->next(heads[r])) {
+            read[r]++;
+            heap.push(HeapEntry(heads[r].timestamp, r));
+        }
+    }
+
+    while (!heap.empty()) {
+        size_t r = heap.top().second;
+        heap.pop();
+        fn(heads[r]);
+        if (readers[r]->next(heads[r])) {
+            read[r]++;
+            heap.push(HeapEntry(heads[r].timestamp, r));
+        }
+    }
+
+    for (size_t r = 0; r < count; r++) {
+        if (readers[r]->failed() || read[r] != runCounts[first + r]) {
+            cerr << "Error: Sort run '" << runFiles[first + r] << "' is damaged ("
+                 << read[r] << " of " << runCounts[first + r] << " records read).\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    finish
+    ------
+    Single run in memory: sort and emit directly.
+    Otherwise: spill the tail run; while more than SORT_MERGE_FAN_IN runs
+    remain, run a pass that merges each group of SORT_MERGE_FAN_IN
+    consecutive runs into one (order kept, so ties still come out in
+    insertion order), then merge what is left straight into fn.
+*/
+bool ExternalActionSorter::finish(const function<void(const UserAction&)>& fn) {
+    if (runFiles.empty()) {
+        stable_sort(buffer.begin(), buffer.end(), byTimestamp);
+        for (const UserAction& a : buffer) fn(a);
+        buffer.clear();
+        bufferedBytes = 0;
+        return true;
+    }
+
+    if (!spillRun()) {
+        removeRuns();
+        return false;
+    }
+
+    bool ok = true;
+    while (ok && runFiles.size() > SORT_MERGE_FAN_IN) {
+        // One pass: each group of consecutive runs becomes one run, in order
+        vector<string> next;
+        vector<size_t> nextCounts;
+        for (size_t first = 0; ok && first < runFiles.size(); first += SORT_MERGE_FAN_IN) {
+            size_t count = min(SORT_MERGE_FAN_IN, runFiles.size() - first);
+            string merged;
+            ok = newRunFile(merged);
+            if (!ok) break;
+            next.push_back(merged);
+
+            EventLogWriter writer(runBlockRecords());
+            size_t written = 0;
+            ok = writer.open(merged);
+            if (ok) {
+                ok = mergeRuns(first, count, [&](const UserAction& a) {
+                    if (ok && !writer.append(a)) ok = false;
+                    written++;
+                }) && ok;
+            }
+            ok = writer.close() && ok;
+            nextCounts.push_back(written);
+        }
+        removeRuns();
+        runFiles.swap(next);
+        runCounts.swap(nextCounts);
+    }
+
+    if (ok) ok = mergeRuns(0, runFiles.size(), fn);
+    removeRuns();
+    return ok;
+}
@@ -1,11 +1,13 @@
 #include "file_io.h"
 #include "linked_list.h"
+#include "log_parser.h"
 #include <iomanip>
 #include <sstream>
 #include <algorithm> // For std::sort
 #include <ctime>
 #include <limits>
 #include <cstring>   // For strcpy
+#include <cstdio>    // For snprintf
 
 using namespace std;
 
@@ -54,89 +56,118 @@ void clearLinkedList(Node*& head) {
     head = nullptr; // Sets the caller's pointer to nullptr after deallocation
 }
 
+/*
+    writeTableHeader / writeTableRow / writeTableFooter
+    ---------------------------------------------------
+    Pieces of the padded report table, so rows can be streamed one at a time.
+*/
+static void writeTableHeader(ostream& file) {
+    file << left << setw(25) << "Timestamp"
+         << setw(10) << "UserID"
+         << setw(20) << "Action"
+         << setw(20) << "Process"
+         << setw(12) << "Duration"
+         << setw(18) << "Next_Action"
+         << setw(10) << "Status" << endl;
+    file << string(120, '-') << endl;
+}
+
+static void writeTableRow(ostream& file, const UserAction& act) {
+    // Convert time_t to readable string
+    char timeStr[25];
+    if (strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&act.timestamp)) == 0) {
+        strcpy(timeStr, "TIME_ERROR");
+    }
+
+    file << left << setw(25) << timeStr
+         << setw(10) << act.userID
+         << setw(20) << act.action
+         << setw(20) << act.processName
+         << setw(12) << fixed << setprecision(2) << act.duration
+         << setw(18) << act.nextAction
+         << setw(10) << act.status << endl;
+}
+
+static void writeTableFooter(ostream& file) {
+    file << string(120, '=') << "\n\n";
+}
+
 /*
     saveActionsToFile
     -----------------
     Saves a linked list of actions to a file in a formatted table.
-    1. Converts List -> Array.
-    2. Sorts the Array by timestamp.
-    3. Writes formatted output.
+    1. Copies List -> ExternalActionSorter.
+    2. Sorts by timestamp: in memory if it fits the budget, otherwise as
+       sorted runs spilled to temp files and k-way merged.
+    3. Streams the formatted rows straight out of the merge.
+    4. Frees the list only once the sort has succeeded; if a spill or the
+       merge fails (disk full, no temp dir) the actions stay in the list.
 */
-bool FileIO::saveActionsToFile(Node*& head, const string& filename) {
+bool FileIO::saveActionsToFile(Node*& head, const string& filename, size_t memoryBudget) {
     if (!head) {
         cerr << "Error: No actions to save!\n";
         return false;
     }
 
-    // 1. Count nodes to determine array size
-    int count = 0;
-    Node* temp = head;
-    while (temp) {
-        count++;
-        temp = temp->next;
+    // Open the output first so a bad path leaves the list untouched
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Error: Could not open file '" << filename << "' for writing.\n";
+        return false;
     }
 
-    if (count == 0) {
+    // 1. Feed the sorter
+    ExternalActionSorter sorter(memoryBudget);
+    bool ok = true;
+    for (Node* temp = head; temp && ok; temp = temp->next) ok = sorter.add(temp->data);
+
+    // 2 + 3. Merge and write (FIFO order)
+    writeTableHeader(file);
+    if (ok) ok = sorter.finish([&](const UserAction& act) {
+        writeTableRow(file, act);
+    });
+    writeTableFooter(file);
+    file.close();
+
+    if (!ok || !file) {
+        cerr << "Error: External sort failed while writing '" << filename
+             << "'; the actions were kept in memory.\n";
         return false;
     }
 
-    // 2. Dynamically allocate a C-style array for sorting
-    UserAction* actions = new UserAction[count];
-
-    // 3. Populate the array (linked list to array conversion)
-    temp = head;
-    for (int i = 0; i < count; ++i) {
-        actions[i] = temp->data;
-        temp = temp->next;
+    // 4. Release the list node by node
+    while (head) {
+        Node* next = head->next;
+        delete head;
+        head = next;
     }
 
-    // 4. Sort the array using std::sort (from <algorithm>)
-    std::sort(actions, actions + count, compareByTimestamp);
+    cout << "\nActions saved to file '" << filename << "' in table format and sorted (FIFO order).\n";
+    return true;
+}
 
-    // 5. Open file and write data
+/*
+    writeActionTable
+    ----------------
+    Writes the padded report table used by saveActionsToFile from an
+    EventTable through a permutation (e.g. EventTable::sortedByTimestamp()),
+    so no rows are moved.
+*/
+bool FileIO::writeActionTable(const EventTable& table, const vector<uint32_t>& order,
+                              const string& filename) {
     ofstream file(filename);
     if (!file.is_open()) {
         cerr << "Error: Could not open file '" << filename << "' for writing.\n";
-        delete[] actions; // Clean up array before exiting
         return false;
     }
 
-    // Write formatted table header
-    file << left << setw(25) << "Timestamp"
-         << setw(10) << "UserID"
-         << setw(20) << "Action"
-         << setw(20) << "Process"
-         << setw(12) << "Duration"
-         << setw(18) << "Next_Action"
-         << setw(10) << "Status" << endl;
-    file << string(120, '-') << endl;
-
-    // Write actions directly from the sorted array (FIFO order)
-    for (int i = 0; i < count; ++i) {
-        const auto& act = actions[i];
-        // Convert time_t to readable string
-        char timeStr[25];
-        if (strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&act.timestamp)) == 0) {
-            strcpy(timeStr, "TIME_ERROR");
-        }
-
-        file << left << setw(25) << timeStr
-             << setw(10) << act.userID
-             << setw(20) << act.action
-             << setw(20) << act.processName
-             << setw(12) << fixed << setprecision(2) << act.duration
-             << setw(18) << act.nextAction
-             << setw(10) << act.status << endl;
+    writeTableHeader(file);
+    for (uint32_t row : order) {
+        writeTableRow(file, table.toUserAction(row));
     }
+    writeTableFooter(file);
 
-    file << string(120, '=') << "\n\n";
     file.close();
-
-    // 6. Deallocate array and linked list
-    delete[] actions;
-    clearLinkedList(head);
-
-    cout << "\nActions saved to file '" << filename << "' in table format and sorted (FIFO order).\n";
     return true;
 }
 
@@ -162,11 +193,40 @@ void FileIO::readFile(const string& filename) {
     file.close();
 }
 
+/*
+    appendActionLine
+    ----------------
+    Formats one action as a labelled log line (with trailing newline) and appends it to out.
+    Shared by saveAction and ActionLogWriter so both produce identical logs.
+    Duration uses "%g", the same text ostream's default formatting produces.
+*/
+void FileIO::appendActionLine(const UserAction& action, string& out) {
+    char num[32];
+
+    out += "UserID: ";
+    out += action.userID;
+    out += ", Action: ";
+    out += action.action;
+    out += ", Process: ";
+    out += action.processName;
+    out += ", Duration: ";
+    snprintf(num, sizeof(num), "%g", action.duration);
+    out += num;
+    out += ", Timestamp: ";
+    out += to_string((long long)action.timestamp);
+    out += ", NextAction: ";
+    out += action.nextAction;
+    out += ", Status: ";
+    out += action.status;
+    out += '\n';
+}
+
 /*
     saveAction
     ----------
     Appends a single user action to a log file.
     Does NOT overwrite existing data (Append Mode).
+    For high event rates use ActionLogWriter, which keeps the file open.
 */
 bool FileIO::saveAction(const UserAction& action, const string& filename) {
     ofstream file(filename, ios::app);
@@ -175,13 +235,9 @@ bool FileIO::saveAction(const UserAction& action, const string& filename) {
         return false;
     }
 
-    file << "UserID: " << action.userID
-         << ", Action: " << action.action
-         << ", Process: " << action.processName
-         << ", Duration: " << action.duration
-         << ", Timestamp: " << action.timestamp
-         << ", NextAction: " << action.nextAction
-         << ", Status: " << action.status << "\n";
+    string line;
+    appendActionLine(action, line);
+    file << line;
 
     file.close();
     return true;
@@ -191,44 +247,27 @@ bool FileIO::saveAction(const UserAction& action, const string& filename) {
     loadActionsFromFile
     -------------------
     Reads actions from a log file and populates a LinkedList.
-    Parses each line to extract UserAction fields.
+    The file is memory-mapped and tokenized in place by LogParser
+    (labelled "UserID: ..., Action: ..." lines or whitespace-separated lines).
+    If stats is given, it receives the number of parsed and rejected lines.
 */
-bool FileIO::loadActionsFromFile(const string& filename, LinkedList& list) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+bool FileIO::loadActionsFromFile(const string& filename, LinkedList& list, ParseStats* stats) {
+    MappedFile file;
+    if (!file.open(filename)) {
         // Fallback: create some data if file not found (helps with testing)
         cerr << "Warning: Could not open input log file. Using fallback data.\n";
         return false;
     }
 
-    string line;
-    while (getline(file, line)) {
-        if (line.empty()) continue;
-
-        UserAction ua;
-        string ignore;
-
-        // Assumes format: UserID: U101, Action: Login, ...
-        stringstream ss(line);
-        
-        // Simple token extraction (works best for space separated values)
-        ss >> ua.userID >> ua.action >> ua.processName >> ua.duration >> ua.timestamp >> ua.nextAction >> ua.status;
-        
-        // If that fails, try the label skipping method:
-        if (ss.fail()) {
-             ss.clear();
-             ss.str(line);
-             ss >> ignore >> ua.userID;      // skip "UserID:"
-             ss >> ignore >> ua.action;      // skip "Action:"
-             ss >> ignore >> ua.processName; // skip "Process:"
-             ss >> ignore >> ua.duration;    // ...
-             ss >> ignore >> ua.timestamp;
-             ss >> ignore >> ua.nextAction;
-             ss >> ignore >> ua.status;
-        }
-
-        list.insertAtEnd(ua);
+    ParseStats result = LogParser::parseBuffer(file.data(), file.data() + file.size(),
+        [&](const ActionFields& f) {
+            list.insertAtEnd(f.toUserAction());
+        });
+
+    if (result.rejected > 0) {
+        cerr << "Warning: Skipped " << result.rejected << " malformed line(s) in '" << filename << "'.\n";
     }
+    if (stats) *stats = result;
 
     return true;
 }
\ No newline at end of file
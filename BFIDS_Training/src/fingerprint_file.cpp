@@ -0,0 +1,93 @@
+#include "fingerprint_file.h"
+
+#include <cstring>
+
+using namespace std;
+
+/*
+    fingerprint_file.cpp
+    --------------------
+    Read side of the binary fingerprint format.
+    The file is mapped as-is; the record table and string pool are used
+    in place, so loading cost is one mmap plus a validation pass.
+*/
+
+const char FingerprintFile::MAGIC[4] = { 'B', 'F', 'F', 'P' };
+
+void FingerprintRecord::setStats(const DurationStats& s) {
+    frequency = s.frequency;
+    reserved = 0;
+    avgDuration = s.avgDuration;
+    m2 = s.m2;
+    minDuration = s.minDuration;
+    maxDuration = s.maxDuration;
+    memcpy(buckets, s.buckets, sizeof(buckets));
+}
+
+DurationStats FingerprintRecord::toStats() const {
+    DurationStats s;
+    s.frequency = frequency;
+    s.avgDuration = avgDuration;
+    s.m2 = m2;
+    s.minDuration = minDuration;
+    s.maxDuration = maxDuration;
+    memcpy(s.buckets, buckets, sizeof(s.buckets));
+    return s;
+}
+
+string FingerprintFile::pathFor(const string& csvPath) {
+    const string ext = ".csv";
+    if (csvPath.size() >= ext.size() &&
+        csvPath.compare(csvPath.size() - ext.size(), ext.size(), ext) == 0) {
+        return csvPath.substr(0, csvPath.size() - ext.size()) + ".bfp";
+    }
+    return csvPath + ".bfp";
+}
+
+/*
+    open
+    ----
+    Maps the file and checks, in order:
+    header magic/version, that the sizes add up to the file length,
+    that every key lies inside the pool, and that keys strictly ascend.
+*/
+bool FingerprintFile::open(const string& filename) {
+    close();
+    if (!file.open(filename)) return false;
+
+    const size_t headerBytes = sizeof(FingerprintHeader);
+    if (file.size() < headerBytes) {
+        close();
+        return false;
+    }
+
+    FingerprintHeader header;
+    memcpy(&header, file.data(), headerBytes);
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FINGERPRINT_FILE_VERSION ||
+        header.count > (file.size() - headerBytes) / sizeof(FingerprintRecord) ||
+        headerBytes + header.count * sizeof(FingerprintRecord) + header.poolBytes != file.size()) {
+        close();
+        return false;
+    }
+
+    records = reinterpret_cast<const FingerprintRecord*>(file.data() + headerBytes);
+    pool = file.data() + headerBytes + header.count * sizeof(FingerprintRecord);
+    count = (size_t)header.count;
+    poolBytes = (size_t)header.poolBytes;
+
+    for (size_t i = 0; i < count; i++) {
+        const FingerprintRecord& r = records[i];
+        if ((uint64_t)r.keyOffset + r.keyLength > poolBytes || (i > 0 && !(key(i - 1) < key(i)))) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void FingerprintFile::close() {
+    file.close();
+    records = nullptr;
+    pool = nullptr;
+    count = poolBytes = 0;
+}
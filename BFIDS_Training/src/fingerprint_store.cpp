@@ -0,0 +1,378 @@
+#include "fingerprint_store.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+/*
+    fingerprint_store.cpp
+    ---------------------
+    Base image + append-only journal for AVLProfile persistence.
+    A save writes only the profiles that changed; the full image is
+    rewritten by compaction, off the caller's thread.
+*/
+
+static const char JOURNAL_MAGIC[4] = { 'B', 'F', 'J', 'L' };
+
+struct JournalHeader {
+    char magic[4];
+    uint32_t version;
+};
+
+struct JournalEntryHeader {
+    uint32_t keyLength;
+    uint32_t checksum;      // FNV-1a (32-bit) over record + key
+    FingerprintRecord record;
+};
+
+static uint32_t checksumOf(const FingerprintRecord& r, string_view key) {
+    uint32_t h = 2166136261u;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(&r);
+    for (size_t i = 0; i < sizeof(r); i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Loops until the whole range is written (handles short writes and EINTR)
+static bool writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool fileExists(const string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+FingerprintStore::FingerprintStore(double compactRatio, size_t minCompactBytes, bool syncOnFlush)
+    : journalFd(-1),
+      journalTorn(false),
+      syncOnFlush(syncOnFlush),
+      compactRatio(compactRatio),
+      minCompactBytes(minCompactBytes),
+      compactOk(true) {}
+
+FingerprintStore::~FingerprintStore() {
+    close();
+}
+
+/*
+    open
+    ----
+    1. Load the base image (missing = empty profile).
+    2. Replay the journal left by an interrupted compaction, if any,
+       then the live journal (a torn tail is cut off).
+    3. Finish the interrupted compaction, so .old never lingers.
+*/
+bool FingerprintStore::open(const string& path, bool fresh) {
+    close();
+    basePath = path;
+    journalPath = path + ".journal";
+    string oldJournal = journalPath + ".old";
+
+    profile.clear();
+    dirty.clear();
+    stats = FingerprintStoreStats();
+    compactOk = true;
+
+    if (fresh) {
+        ::unlink(basePath.c_str());
+        ::unlink(journalPath.c_str());
+        ::unlink(oldJournal.c_str());
+    }
+
+    struct stat st;
+    if (::stat(basePath.c_str(), &st) == 0) {
+        if (!profile.importFromBinary(basePath)) {
+            cerr << "Error: '" << basePath << "' is not a valid binary fingerprint.\n";
+            return false;
+        }
+        stats.baseBytes = (size_t)st.st_size;
+    }
+
+    bool interrupted = fileExists(oldJournal);
+    if (interrupted && !replay(oldJournal, false)) return false;
+    if (!replay(journalPath, true)) return false;
+    if (!openJournal(false)) return false;
+
+    if (interrupted) return compact(false);
+    return true;
+}
+
+/*
+    replay
+    ------
+    Applies every intact record of a journal. Stops at the first record
+    that is cut short or fails its checksum (a crash during an append);
+    truncateTail removes that tail so new records follow intact ones.
+*/
+bool FingerprintStore::replay(const string& path, bool truncateTail) {
+    MappedFile file;
+    if (!file.open(path) || file.size() == 0) return true;
+
+    const char* data = file.data();
+    size_t size = file.size();
+    JournalHeader header;
+    if (size < sizeof(header)) {
+        cerr << "Error: '" << path << "' is not a fingerprint journal.\n";
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        header.version != FINGERPRINT_JOURNAL_VERSION) {
+        cerr << "Error: '" << path << "' is not a fingerprint journal.\n";
+        return false;
+    }
+
+    size_t pos = sizeof(header);
+    while (size - pos >= sizeof(JournalEntryHeader)) {
+        JournalEntryHeader entry;
+        memcpy(&entry, data + pos, sizeof(entry));
+        if (entry.keyLength > size - pos - sizeof(entry)) break;
+
+        string_view key(data + pos + sizeof(entry), entry.keyLength);
+        if (checksumOf(entry.record, key) != entry.checksum) break;
+
+        profile.insertProfileDirect(UserActionProfile(string(key), entry.record.toStats()));
+        stats.recordsReplayed++;
+        pos += sizeof(entry) + entry.keyLength;
+    }
+
+    file.close();
+    if (pos < size) {
+        cerr << "Warning: Dropped " << (size - pos) << " bytes of incomplete journal records in '"
+             << path << "'.\n";
+        if (truncateTail && ::truncate(path.c_str(), (off_t)pos) != 0) {
+            cerr << "Error: Could not truncate '" << path << "'.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Opens the live journal for appending; writes the header if it is new
+bool FingerprintStore::openJournal(bool truncate) {
+    int flags = O_WRONLY | O_APPEND | O_CREAT | (truncate ? O_TRUNC : 0);
+    journalFd = ::open(journalPath.c_str(), flags, 0644);
+    journalTorn = false;
+    if (journalFd < 0) {
+        cerr << "Error: Could not open journal '" << journalPath << "'.\n";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(journalFd, &st) != 0) return false;
+    stats.journalBytes = (size_t)st.st_size;
+    if (stats.journalBytes == 0) {
+        JournalHeader header;
+        memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = FINGERPRINT_JOURNAL_VERSION;
+        if (!writeAll(journalFd, reinterpret_cast<const char*>(&header), sizeof(header))) return false;
+        stats.journalBytes = sizeof(header);
+    }
+    return true;
+}
+
+bool FingerprintStore::close() {
+    bool ok = true;
+    if (journalFd >= 0) {
+        ok = flush();
+        waitForCompaction();
+        ::close(journalFd);
+        journalFd = -1;
+    } else {
+        waitForCompaction();
+    }
+    return ok && compactOk;
+}
+
+// ===================== UPDATES =====================
+
+void FingerprintStore::markDirty(string_view processName) {
+    if (dirty.find(processName) == dirty.end()) dirty.emplace(processName);
+}
+
+void FingerprintStore::insertOrUpdate(string_view processName, double duration) {
+    profile.insertOrUpdate(processName, duration);
+    markDirty(processName);
+}
+
+void FingerprintStore::insertOrUpdateBatch(const DurationSample* samples, size_t count) {
+    profile.insertOrUpdateBatch(samples, count);
+    for (size_t i = 0; i < count; i++) markDirty(samples[i].first);
+}
+
+void FingerprintStore::mergeProfile(const UserActionProfile& p) {
+    profile.mergeProfile(p);
+    markDirty(p.processName);
+}
+
+void FingerprintStore::insertProfileDirect(const UserActionProfile& p) {
+    profile.insertProfileDirect(p);
+    markDirty(p.processName);
+}
+
+// ===================== PERSISTENCE =====================
+
+/*
+    appendDirty
+    -----------
+    Encodes the current stats of every dirty name and appends them with
+    one write(). The names stay dirty until the write (and the sync, with
+    syncOnFlush) succeeded. A failed append is cut off again, back to the
+    last good length (stats.journalBytes), so no torn record ends up in
+    front of later ones; if even that fails, the next append retries the
+    truncation before writing anything.
+*/
+bool FingerprintStore::appendDirty() {
+    if (journalFd < 0) return false;
+    if (journalTorn) {
+        if (::ftruncate(journalFd, (off_t)stats.journalBytes) != 0) {
+            cerr << "Error: Could not cut the failed append off journal '" << journalPath << "'.\n";
+            return false;
+        }
+        journalTorn = false;
+    }
+    if (dirty.empty()) return true;
+
+    string buffer;
+    buffer.reserve(dirty.size() * (sizeof(JournalEntryHeader) + 32));
+    UserActionProfile p;
+    uint64_t records = 0;
+    for (const string& name : dirty) {
+        if (!profile.search(name, p)) continue;
+
+        JournalEntryHeader entry;
+        entry.keyLength = (uint32_t)name.size();
+        entry.record.keyOffset = 0;
+        entry.record.keyLength = entry.keyLength;
+        entry.record.setStats(p);
+        entry.checksum = checksumOf(entry.record, name);
+        buffer.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        buffer.append(name);
+        records++;
+    }
+
+    bool ok = writeAll(journalFd, buffer.data(), buffer.size());
+    if (ok && syncOnFlush) ok = ::fdatasync(journalFd) == 0;
+    if (!ok) {
+        cerr << "Error: Failed to append to journal '" << journalPath << "'; "
+             << dirty.size() << " profile(s) stay dirty.\n";
+        journalTorn = ::ftruncate(journalFd, (off_t)stats.journalBytes) != 0;
+        return false;
+    }
+    dirty.clear();
+    stats.recordsWritten += records;
+    stats.flushes++;
+    stats.journalBytes += buffer.size();
+    return true;
+}
+
+// Starts a background compaction once the journal is large relative to the base
+bool FingerprintStore::flush() {
+    if (!appendDirty()) return false;
+
+    size_t limit = max(minCompactBytes, (size_t)(compactRatio * stats.baseBytes));
+    if (stats.journalBytes > limit) return compact(true);
+    return true;
+}
+
+/*
+    compact
+    -------
+    1. Wait for the previous compaction and flush, so the profile equals
+       base + journal exactly.
+    2. Retire the journal to .old (appended to an .old still left by a
+       failed compaction) and start an empty one.
+    3. Encode the profile in memory, then write it as the new base and
+       delete .old, in a background thread unless background=false.
+*/
+bool FingerprintStore::compact(bool background) {
+    if (journalFd < 0) return false;
+    waitForCompaction();
+    if (!appendDirty()) return false;
+
+    ::close(journalFd);
+    journalFd = -1;
+    string oldJournal = journalPath + ".old";
+
+    bool retired;
+    if (fileExists(oldJournal)) {
+        MappedFile live;
+        int fd = ::open(oldJournal.c_str(), O_WRONLY | O_APPEND);
+        retired = fd >= 0 && live.open(journalPath);
+        if (retired && live.size() > sizeof(JournalHeader)) {
+            retired = writeAll(fd, live.data() + sizeof(JournalHeader), live.size() - sizeof(JournalHeader)) &&
+                      ::fsync(fd) == 0;
+        }
+        if (fd >= 0) ::close(fd);
+    } else {
+        retired = ::rename(journalPath.c_str(), oldJournal.c_str()) == 0;
+    }
+    if (!retired) {
+        cerr << "Error: Could not retire journal '" << journalPath << "'.\n";
+        openJournal(false);
+        return false;
+    }
+    if (!openJournal(true)) return false;
+
+    string image;
+    profile.encodeBinary(image);
+    stats.baseBytes = image.size();
+    stats.compactions++;
+
+    if (!background) {
+        compactOk = writeBase(image, basePath, oldJournal);
+        return compactOk;
+    }
+    compactor = thread([this, image = move(image), base = basePath, oldJournal]() {
+        compactOk = writeBase(image, base, oldJournal);
+    });
+    return true;
+}
+
+void FingerprintStore::waitForCompaction() {
+    if (compactor.joinable()) compactor.join();
+}
+
+/*
+    writeBase
+    ---------
+    base.tmp is written and synced completely before it replaces the
+    base, so the base on disk is always a whole image. Only then is the
+    retired journal (now contained in the base) removed.
+*/
+bool FingerprintStore::writeBase(const string& image, const string& basePath, const string& oldJournal) {
+    string tmp = basePath + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0 && writeAll(fd, image.data(), image.size()) && ::fsync(fd) == 0;
+    if (fd >= 0) ::close(fd);
+    ok = ok && ::rename(tmp.c_str(), basePath.c_str()) == 0;
+    if (!ok) {
+        cerr << "Error: Could not rewrite fingerprint base '" << basePath << "'.\n";
+        return false;
+    }
+    ::unlink(oldJournal.c_str());
+    return true;
+}
@@ -0,0 +1,217 @@
+#include "frozen_profile.h"
+#include "fingerprint_file.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace std;
+
+/*
+    frozen_profile.cpp
+    ------------------
+    Read-only Eytzinger snapshot of an AVLProfile.
+    An AVL search hops between nodes scattered across the heap; here the
+    implicit tree lives in one aligned array, the next levels are
+    prefetched ahead of the comparison, and almost every level is decided
+    by a hash check plus two integer compares.
+*/
+
+static const size_t SLOT_ALIGN = 128;
+
+// 64-bit FNV-1a
+static uint64_t hashKey(string_view s) {
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// First 16 bytes as two big-endian words; word order == byte order
+static void packPrefix(string_view s, uint64_t prefix[2]) {
+    for (int w = 0; w < 2; w++) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < 8; i++) {
+            size_t pos = w * 8 + i;
+            v = (v << 8) | (pos < s.size() ? (unsigned char)s[pos] : 0);
+        }
+        prefix[w] = v;
+    }
+}
+
+FrozenProfile::FrozenProfile() : slots(nullptr), n(0) {}
+
+FrozenProfile::~FrozenProfile() {
+    release();
+}
+
+void FrozenProfile::release() {
+    free(slots);
+    slots = nullptr;
+    n = 0;
+}
+
+FrozenProfile::FrozenProfile(FrozenProfile&& other) noexcept
+    : slots(other.slots), stats(move(other.stats)), keyArena(move(other.keyArena)), n(other.n) {
+    other.slots = nullptr;
+    other.n = 0;
+}
+
+FrozenProfile& FrozenProfile::operator=(FrozenProfile&& other) noexcept {
+    if (this != &other) {
+        release();
+        slots = other.slots;
+        stats = move(other.stats);
+        keyArena = move(other.keyArena);
+        n = other.n;
+        other.slots = nullptr;
+        other.n = 0;
+    }
+    return *this;
+}
+
+/*
+    allocate
+    --------
+    Sizes the slot array (rounded up to whole aligned blocks) and stats.
+*/
+void FrozenProfile::allocate(size_t count) {
+    release();
+    n = count;
+
+    size_t bytes = (n + 1) * sizeof(Slot);
+    bytes = (bytes + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+    slots = static_cast<Slot*>(aligned_alloc(SLOT_ALIGN, bytes));
+    if (!slots) throw bad_alloc();
+    memset(slots, 0, bytes);
+
+    stats.assign(n + 1, DurationStats());
+}
+
+void FrozenProfile::place(size_t k, string_view key, uint32_t keyOffset, const DurationStats& s) {
+    Slot& slot = slots[k];
+    slot.hash = hashKey(key);
+    packPrefix(key, slot.prefix);
+    slot.keyOffset = keyOffset;
+    slot.keyLength = (uint32_t)key.size();
+    stats[k] = s;
+}
+
+/*
+    fill
+    ----
+    In-order traversal of the implicit tree rooted at k: left subtree,
+    then slot k takes the next sorted item, then the right subtree.
+    So BFS slot order still means sorted key order.
+    Returns the index of the next unused item.
+*/
+template <typename Put>
+size_t FrozenProfile::fill(size_t next, size_t k, Put& put) {
+    if (k > n) return next;
+
+    next = fill(next, 2 * k, put);
+    put(k, next++);
+    return fill(next, 2 * k + 1, put);
+}
+
+/*
+    Constructor (build)
+    -------------------
+    Copies the sorted profiles into Eytzinger order.
+*/
+FrozenProfile::FrozenProfile(const vector<UserActionProfile>& sorted) : slots(nullptr), n(0) {
+    allocate(sorted.size());
+
+    size_t arenaBytes = 0;
+    for (const UserActionProfile& p : sorted) arenaBytes += p.processName.size();
+    keyArena.reserve(arenaBytes);
+
+    auto put = [&](size_t k, size_t i) {
+        const UserActionProfile& p = sorted[i];
+        place(k, p.processName, (uint32_t)keyArena.size(), p);
+        keyArena.insert(keyArena.end(), p.processName.begin(), p.processName.end());
+    };
+    fill(0, 1, put);
+}
+
+/*
+    loadBinary
+    ----------
+    The file's records are already sorted and its pool offsets stay valid
+    once the pool is copied, so slots point straight into the copy.
+*/
+bool FrozenProfile::loadBinary(const string& filename) {
+    FingerprintFile file;
+    if (!file.open(filename)) return false;
+
+    allocate(file.size());
+    keyArena.assign(file.poolData(), file.poolData() + file.poolSize());
+
+    auto put = [&](size_t k, size_t i) {
+        const FingerprintRecord& r = file.record(i);
+        place(k, file.key(i), r.keyOffset, r.toStats());
+    };
+    fill(0, 1, put);
+    return true;
+}
+
+/*
+    locate
+    ------
+    Walks the implicit tree from slot 1. At each level:
+    1. Prefetch the grandchildren block (slots 4k..4k+3).
+    2. Hash match -> confirm equality and stop.
+    3. Otherwise branch on the 16-byte prefix; only a prefix tie reads
+       the arena for a full compare.
+    Returns the slot index, or 0 if not found.
+*/
+size_t FrozenProfile::locate(string_view processName) const {
+    if (n == 0) return 0;
+
+    uint64_t hash = hashKey(processName);
+    uint64_t prefix[2];
+    packPrefix(processName, prefix);
+
+    size_t k = 1;
+    while (k <= n) {
+        __builtin_prefetch(slots + 4 * k);
+        __builtin_prefetch(slots + 4 * k + 2);
+
+        const Slot& s = slots[k];
+        if (s.hash == hash && s.keyLength == processName.size() &&
+            s.prefix[0] == prefix[0] && s.prefix[1] == prefix[1] &&
+            (s.keyLength <= 16 ||
+             memcmp(keyArena.data() + s.keyOffset + 16, processName.data() + 16, s.keyLength - 16) == 0)) {
+            return k;
+        }
+
+        bool right;
+        if (prefix[0] != s.prefix[0]) right = prefix[0] > s.prefix[0];
+        else if (prefix[1] != s.prefix[1]) right = prefix[1] > s.prefix[1];
+        else right = processName.compare(string_view(keyArena.data() + s.keyOffset, s.keyLength)) > 0;
+
+        k = 2 * k + (right ? 1 : 0);
+    }
+    return 0;
+}
+
+const DurationStats* FrozenProfile::find(string_view processName) const {
+    size_t k = locate(processName);
+    return k ? &stats[k] : nullptr;
+}
+
+/*
+    search
+    ------
+    Drop-in for AVLProfile::search.
+*/
+bool FrozenProfile::search(string_view processName, UserActionProfile& outProfile) const {
+    size_t k = locate(processName);
+    if (!k) return false;
+
+    outProfile.processName.assign(processName.data(), processName.size());
+    static_cast<DurationStats&>(outProfile) = stats[k];
+    return true;
+}
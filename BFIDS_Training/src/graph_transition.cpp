@@ -28,11 +28,13 @@ void GraphTransition::addTransition(const string& fromState, const string& toSta
     -----------------
     Checks if a direct edge exists between two states.
     Returns true if the transition is allowed.
+    Uses find() only, so an unknown state is never inserted.
 */
-bool GraphTransition::isValidTransition(const string& fromState, const string& toState) {
-    if (adjList.find(fromState) == adjList.end()) return false;
+bool GraphTransition::isValidTransition(string_view fromState, string_view toState) const {
+    auto it = adjList.find(fromState);
+    if (it == adjList.end()) return false;
     
-    const vector<string>& neighbors = adjList[fromState];
+    const vector<string>& neighbors = it->second;
     for (const string& neighbor : neighbors) {
         if (neighbor == toState) return true;
     }
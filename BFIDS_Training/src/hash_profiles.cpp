@@ -3,62 +3,143 @@
 /*
     hash_profiles.cpp
     -----------------
-    Implements a Hash Table with Chaining for collision resolution.
+    Implements the user registry as an open-addressing hash table with
+    Robin Hood probing and incremental growth.
     Used for fast O(1) retrieval of user profiles by UserID.
 */
 
 /*
     hashFunction
     ------------
-    Computes a hash index for a given string key.
-    Uses a polynomial rolling hash strategy.
+    64-bit FNV-1a over the key, then the MurmurHash3 finalizer so every
+    input bit reaches the low bits used as the slot index (the table size
+    is a power of two: the index is hash & mask, no modulo).
 */
-int hashTable::hashFunction(const string& key) const {
-    long long hash = 0;
-    for (char c : key) {
-        hash = (hash * 37 + c) % capacity;
+uint32_t hashTable::hashFunction(string_view key) {
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ull;
     }
-    return (int)hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return (uint32_t)h;
 }
 
-// Constructor
-hashTable::hashTable(int size) {
-    capacity = size;
-    table = new hashNode*[capacity];
+// How far the slot at pos sits from its home slot
+size_t hashTable::probeDistance(const vector<Slot>& slots, size_t pos, uint32_t hash) {
+    size_t mask = slots.size() - 1;
+    return (pos - (hash & mask)) & mask;
+}
 
-    for (int i = 0; i < capacity; i++)
-        table[i] = nullptr;
+// Constructor
+hashTable::hashTable(int size) : migrated(0) {
+    size_t capacity = 16;
+    while (capacity * REGISTRY_MAX_LOAD < (double)size) capacity *= 2;
+    table.assign(capacity, Slot{ EMPTY, 0 });
+    entries.reserve(size > 0 ? (size_t)size : 0);
 }
 
-// Destructor
-hashTable::~hashTable() {
-    for (int i = 0; i < capacity; i++) {
-        hashNode* curr = table[i];
-        while (curr) {
-            hashNode* temp = curr;
-            curr = curr->next;
-            delete temp; 
-            // Note: We do NOT delete profilePtr here as the AVL tree 
-            // might be managed/allocated elsewhere in your main system.
+/*
+    place
+    -----
+    Robin Hood insertion: walk from the home slot; whenever the resident
+    entry is closer to its own home than the one being placed, swap them
+    and carry the displaced entry on.
+*/
+void hashTable::place(vector<Slot>& slots, Slot s) {
+    size_t mask = slots.size() - 1;
+    size_t pos = s.hash & mask;
+    size_t dist = 0;
+    while (slots[pos].entry != EMPTY) {
+        size_t d = probeDistance(slots, pos, slots[pos].hash);
+        if (d < dist) {
+            swap(s, slots[pos]);
+            dist = d;
         }
+        pos = (pos + 1) & mask;
+        dist++;
+    }
+    slots[pos] = s;
+}
+
+/*
+    find
+    ----
+    Returns the slot holding key, or -1. The probe stops at an empty slot
+    or at an entry closer to its home than the current distance: with
+    Robin Hood ordering the key cannot be further along.
+*/
+long hashTable::find(const vector<Slot>& slots, string_view key, uint32_t hash) const {
+    size_t mask = slots.size() - 1;
+    size_t pos = hash & mask;
+    for (size_t dist = 0;; dist++) {
+        const Slot& s = slots[pos];
+        if (s.entry == EMPTY || probeDistance(slots, pos, s.hash) < dist) return -1;
+        if (s.hash == hash && entries[s.entry].userId == key) return (long)pos;
+        pos = (pos + 1) & mask;
+    }
+}
+
+/*
+    grow
+    ----
+    Starts a resize: the current table becomes the old one and new
+    entries go to a table twice the size. The old slots are moved over
+    by migrate() a few at a time.
+*/
+void hashTable::grow() {
+    oldTable.swap(table);
+    table.assign(oldTable.size() * 2, Slot{ EMPTY, 0 });
+    migrated = 0;
+}
+
+void hashTable::migrate(size_t steps) {
+    while (steps-- > 0 && migrated < oldTable.size()) {
+        if (oldTable[migrated].entry != EMPTY) place(table, oldTable[migrated]);
+        migrated++;
+    }
+    if (migrated == oldTable.size()) {
+        vector<Slot>().swap(oldTable);
+        migrated = 0;
     }
-    delete[] table;
 }
 
 /*
     addProfile
     ----------
-    Inserts a new profile pointer into the hash table.
-    Handles collisions using linked list chaining (add at head).
+    Registers userId -> profilePtr. An ID that is already present keeps
+    its slot and only has the pointer replaced (both tables share the
+    entry, so this holds mid-resize too). A new ID first advances any
+    resize in progress, then starts one if the table is over its load.
 */
-void hashTable::addProfile(const string& userId, AVLProfile* profilePtr) {
-    int index = hashFunction(userId);
+bool hashTable::addProfile(const string& userId, AVLProfile* profilePtr) {
+    uint32_t h = hashFunction(userId);
+
+    long pos = find(table, userId, h);
+    const vector<Slot>* where = &table;
+    if (pos < 0 && !oldTable.empty()) {
+        pos = find(oldTable, userId, h);
+        where = &oldTable;
+    }
+    if (pos >= 0) {
+        entries[(*where)[pos].entry].profilePtr = profilePtr;
+        return false;
+    }
 
-    hashNode* newNode = new hashNode(userId, profilePtr);
-    newNode->next = table[index];
-    table[index] = newNode;
+    if (!oldTable.empty()) migrate(REGISTRY_MIGRATE_STEP);
+    if ((double)(entries.size() + 1) > REGISTRY_MAX_LOAD * table.size()) {
+        // Still draining the previous resize (only with a tiny table): finish it first
+        if (!oldTable.empty()) migrate(oldTable.size());
+        grow();
+    }
 
-    cout << "[hashTable] Added profile for: " << userId << " at index " << index << endl;
+    entries.push_back(Entry{ userId, profilePtr });
+    place(table, Slot{ (uint32_t)(entries.size() - 1), h });
+    return true;
 }
 
 /*
@@ -67,32 +148,67 @@ void hashTable::addProfile(const string& userId, AVLProfile* profilePtr) {
     Retrieves the AVLProfile associated with a UserID.
     Returns nullptr if the user is not found.
 */
-AVLProfile* hashTable::getProfile(const string& userId) {
-    int index = hashFunction(userId);
-
-    hashNode* curr = table[index];
-    while (curr) {
-        if (curr->userId == userId)
-            return curr->profilePtr;
-        curr = curr->next;
+AVLProfile* hashTable::getProfile(string_view userId) const {
+    uint32_t h = hashFunction(userId);
+
+    long pos = find(table, userId, h);
+    if (pos >= 0) return entries[table[pos].entry].profilePtr;
+    if (!oldTable.empty()) {
+        pos = find(oldTable, userId, h);
+        if (pos >= 0) return entries[oldTable[pos].entry].profilePtr;
     }
     return nullptr;
 }
 
+/*
+    stats
+    -----
+    Load factor of the current table and the probe length (slots
+    inspected) a successful lookup needs, averaged and worst case, over
+    every entry in either table.
+*/
+RegistryStats hashTable::stats() const {
+    RegistryStats r;
+    r.size = entries.size();
+    r.capacity = table.size();
+    r.loadFactor = (double)r.size / r.capacity;
+    r.rehashing = !oldTable.empty();
+
+    size_t total = 0, counted = 0;
+    auto scanSlots = [&](const vector<Slot>& slots, size_t from) {
+        for (size_t i = from; i < slots.size(); i++) {
+            if (slots[i].entry == EMPTY) continue;
+            int probe = (int)probeDistance(slots, i, slots[i].hash) + 1;
+            total += probe;
+            counted++;
+            if (probe > r.maxProbe) r.maxProbe = probe;
+        }
+    };
+    scanSlots(table, 0);
+    if (r.rehashing) scanSlots(oldTable, migrated);
+    r.avgProbe = counted ? (double)total / counted : 0.0;
+    return r;
+}
+
 /*
     displayTable
     ------------
-    Prints the contents of the hash table (buckets and chains).
+    Prints the occupied slots (with their probe distance) and the table
+    statistics.
 */
 void hashTable::displayTable() const {
+    RegistryStats s = stats();
     cout << "\n---- Hash Table ----\n";
-    for (int i = 0; i < capacity; i++) {
-        cout << "[" << i << "] ";
-        hashNode* curr = table[i];
-        while (curr) {
-            cout << "(" << curr->userId << ") -> ";
-            curr = curr->next;
-        }
-        cout << "NULL\n";
+    for (size_t i = 0; i < table.size(); i++) {
+        if (table[i].entry == EMPTY) continue;
+        cout << "[" << i << "] (" << entries[table[i].entry].userId << ") +"
+             << probeDistance(table, i, table[i].hash) << "\n";
     }
-}
\ No newline at end of file
+    for (size_t i = migrated; i < oldTable.size(); i++) {
+        if (oldTable[i].entry == EMPTY) continue;
+        cout << "[old " << i << "] (" << entries[oldTable[i].entry].userId << ")\n";
+    }
+    cout << s.size << " users, " << s.capacity << " slots, load " << s.loadFactor
+         << ", probe avg " << s.avgProbe << " max " << s.maxProbe
+         << (s.rehashing ? " (resizing)" : "") << "\n";
+}
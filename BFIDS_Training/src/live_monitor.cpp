@@ -2,6 +2,10 @@
 #include <string>
 #include <cstdlib> // For system()
 #include "avl_profile.h"
+#include "frozen_profile.h"
+#include "fingerprint_file.h"
+#include "event_log.h"
+#include "log_follower.h"
 
 using namespace std;
 
@@ -14,6 +18,9 @@ using namespace std;
     
     Features:
     - Manual data entry simulation.
+    - Replay of a binary event log (./live_monitor events.bfev).
+    - Follow mode: tails a growing text action log and scores every
+      appended line in batches (./live_monitor --follow data/ali_actions.log).
     - Anomaly detection based on imported CSV profiles.
     - Simulated shutdown trigger.
 */
@@ -38,32 +45,118 @@ void triggerShutdown() {
     system("sudo shutdown -h now"); 
 }
 
+/*
+    evaluateAction
+    --------------
+    Scores one observed action against the profile and updates the threat level.
+    Returns true if the threshold was reached and the system was shut down.
+    quiet=true only prints anomalies (used for high-volume follow mode).
+*/
+bool evaluateAction(const FrozenProfile& profile, string_view action, double duration,
+                    int& currentThreatLevel, bool quiet = false) {
+    const DurationStats* stats = profile.find(action);
+
+    if (!stats) {
+        cout << "   -> [ALERT] UNKNOWN BEHAVIOR! User has never done '" << action << "' before." << endl;
+        currentThreatLevel += 5;
+    } else {
+        // Check if they are doing it way too slow/fast (3x deviation)
+        // Upper limit from the learned spread (p99 / mean + 3 sd), capped at 3x the mean
+        double limit = stats->upperBound(3.0);
+        if (duration > limit) {
+            cout << "   -> [WARNING] TIMING ANOMALY! Action took " << duration << "ms (Expected: ~" << stats->avgDuration
+                 << "ms, limit " << limit << "ms)" << endl;
+            currentThreatLevel += 3;
+        } else {
+            if (!quiet) cout << "   -> [OK] Behavior matches normal profile." << endl;
+            if (currentThreatLevel > 0) currentThreatLevel--; // Cool down
+        }
+    }
+
+    if (!quiet) cout << "   -> Current Threat Score: " << currentThreatLevel << "/10" << endl;
+
+    // The Consequence
+    if (currentThreatLevel >= ANOMALY_THRESHOLD) {
+        triggerShutdown();
+        return true;
+    }
+    return false;
+}
+
 /*
     main
     ----
     Simulation loop.
     1. Loads the fingerprint.
-    2. Accepts manual input for Action and Duration.
+    2. Accepts manual input for Action and Duration
+       (or replays every event of a binary event log given as argument).
     3. Calculates threat score.
     4. Triggers shutdown if threshold is met.
 */
-int main() {
+int main(int argc, char* argv[]) {
     cout << "============================================" << endl;
     cout << "   BFIDS LIVE MONITORING SYSTEM (ACTIVE)    " << endl;
     cout << "============================================" << endl;
 
     // 1. Load the "Brain" (The patterns we learned from the static file)
-    AVLProfile validProfile;
-    if (!validProfile.importFromCSV(FINGERPRINT_FILE)) {
-        cerr << "[ERROR] No training data found! Run ./trainer first." << endl;
-        return 1;
+    // Detection never changes the profile: use the read-only lookup snapshot.
+    // The binary fingerprint maps straight into it; the CSV is the fallback.
+    FrozenProfile detectionProfile;
+    if (!detectionProfile.loadBinary(FingerprintFile::pathFor(FINGERPRINT_FILE))) {
+        AVLProfile validProfile;
+        if (!validProfile.importFromCSV(FINGERPRINT_FILE)) {
+            cerr << "[ERROR] No training data found! Run ./trainer first." << endl;
+            return 1;
+        }
+        detectionProfile = validProfile.freeze();
     }
     cout << "[System] Behavioral Patterns Loaded. Watching for anomalies...\n" << endl;
 
-    // 2. The Infinite Loop (This is the "Live" part)
+    int currentThreatLevel = 0;
+
+    // 2a. Follow mode: tail a growing action log
+    if (argc >= 3 && string(argv[1]) == "--follow") {
+        LogFollower follower;
+        if (!follower.open(argv[2])) return 1;
+        cout << "[System] Following '" << argv[2] << "' (Ctrl+C to stop)..." << endl;
+
+        bool shutdown = false;
+        while (!shutdown) {
+            ParseStats batch;
+            size_t anomalies = 0;
+            follower.poll(1000, batch, [&](const ActionFields& f) {
+                if (shutdown) return;
+                int before = currentThreatLevel;
+                shutdown = evaluateAction(detectionProfile, f.processName, f.duration, currentThreatLevel, true);
+                if (currentThreatLevel > before) anomalies++;
+            });
+            if (batch.parsed + batch.rejected > 0) {
+                cout << "[FOLLOW] Batch: " << batch.parsed << " events, " << anomalies
+                     << " anomalies, " << batch.rejected << " malformed | Threat Score: "
+                     << currentThreatLevel << "/10" << endl;
+            }
+        }
+        return 0;
+    }
+
+    // 2b. Replay mode: score a recorded binary event log
+    if (argc >= 2) {
+        EventLogReader reader;
+        if (!reader.open(argv[1])) {
+            cerr << "[ERROR] '" << argv[1] << "' is not a binary event log." << endl;
+            return 1;
+        }
+        UserAction event;
+        while (reader.next(event)) {
+            cout << "\n[REPLAY] " << event.processName << " (" << event.duration << "ms)" << endl;
+            if (evaluateAction(detectionProfile, event.processName, event.duration, currentThreatLevel)) break;
+        }
+        return 0;
+    }
+
+    // 2c. The Infinite Loop (This is the "Live" part)
     string action;
     double duration;
-    int currentThreatLevel = 0;
 
     while (true) {
         // A. Wait for real-time input
@@ -75,31 +168,8 @@ int main() {
         cin >> duration;
 
         // B. Compare against the Profile
-        UserActionProfile stats;
-        bool known = validProfile.search(action, stats);
-
-        if (!known) {
-            cout << "   -> [ALERT] UNKNOWN BEHAVIOR! User has never done '" << action << "' before." << endl;
-            currentThreatLevel += 5;
-        } else {
-            // Check if they are doing it way too slow/fast (3x deviation)
-            if (duration > stats.avgDuration * 3.0) {
-                cout << "   -> [WARNING] TIMING ANOMALY! Action took " << duration << "ms (Expected: ~" << stats.avgDuration << "ms)" << endl;
-                currentThreatLevel += 3;
-            } else {
-                cout << "   -> [OK] Behavior matches normal profile." << endl;
-                if (currentThreatLevel > 0) currentThreatLevel--; // Cool down
-            }
-        }
-
-        cout << "   -> Current Threat Score: " << currentThreatLevel << "/10" << endl;
-
-        // C. The Consequence
-        if (currentThreatLevel >= ANOMALY_THRESHOLD) {
-            triggerShutdown();
-            break; 
-        }
+        if (evaluateAction(detectionProfile, action, duration, currentThreatLevel)) break;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,249 @@
+#include "log_follower.h"
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+    log_follower.cpp
+    ----------------
+    Follows a growing action log without re-reading it.
+    inotify wakes the follower up when the file is written or when the
+    directory gains a new entry (log rotation); the follower then pread()s
+    only the bytes past its stored offset and parses them with LogParser.
+*/
+
+static const size_t READ_CHUNK = 1 << 16;
+
+LogFollower::LogFollower()
+    : fd(-1), inotifyFd(-1), fileWatch(-1), dirWatch(-1), offset(0), inode(0), discarding(false) {}
+
+LogFollower::~LogFollower() {
+    close();
+}
+
+// Directory part of a path ("." if there is none)
+static string directoryOf(const string& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == string::npos) return ".";
+    if (slash == 0) return "/";
+    return path.substr(0, slash);
+}
+
+/*
+    openFile
+    --------
+    (Re)opens the followed path and watches it for writes and rotation.
+*/
+bool LogFollower::openFile(bool fromStart) {
+    int newFd = ::open(path.c_str(), O_RDONLY);
+    if (newFd < 0) return false;
+
+    struct stat st;
+    if (fstat(newFd, &st) != 0) {
+        ::close(newFd);
+        return false;
+    }
+
+    if (fd >= 0) ::close(fd);
+    fd = newFd;
+    inode = st.st_ino;
+    offset = fromStart ? 0 : st.st_size;
+    pending.clear();
+    discarding = false;
+
+    if (inotifyFd >= 0) {
+        if (fileWatch >= 0) inotify_rm_watch(inotifyFd, fileWatch);
+        fileWatch = inotify_add_watch(inotifyFd, path.c_str(),
+                                      IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+    }
+    return true;
+}
+
+/*
+    open
+    ----
+    Starts following filename. The directory is watched as well so a
+    recreated file (after rotation) is noticed immediately.
+*/
+bool LogFollower::open(const string& filename, bool fromStart) {
+    close();
+    path = filename;
+
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0) {
+        dirWatch = inotify_add_watch(inotifyFd, directoryOf(path).c_str(), IN_CREATE | IN_MOVED_TO);
+    } else {
+        cerr << "[Follow] inotify unavailable, falling back to timed polling.\n";
+    }
+
+    if (!openFile(fromStart)) {
+        cerr << "Error: Could not open '" << filename << "' to follow.\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LogFollower::close() {
+    if (fd >= 0) ::close(fd);
+    if (inotifyFd >= 0) ::close(inotifyFd); // Also drops its watches
+    fd = inotifyFd = fileWatch = dirWatch = -1;
+    offset = 0;
+    inode = 0;
+    pending.clear();
+    discarding = false;
+}
+
+/*
+    drainEvents
+    -----------
+    Discards queued inotify events. We don't need their details: any event
+    just means "check the file again".
+*/
+void LogFollower::drainEvents() {
+    if (inotifyFd < 0) return;
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while (::read(inotifyFd, buf, sizeof(buf)) > 0) {}
+}
+
+/*
+    consume
+    -------
+    Parses the complete lines of one chunk, together with the partial line
+    held back from the previous one. The new trailing partial line is kept
+    in 'pending', unless it has outgrown LOG_FOLLOWER_MAX_LINE: then it is
+    rejected and the bytes up to its newline are skipped.
+*/
+void LogFollower::consume(const char* data, size_t len, ParseStats& stats,
+                          const function<void(const ActionFields&)>& fn) {
+    const char* end = data + len;
+    if (discarding) {
+        const char* nl = static_cast<const char*>(memchr(data, '\n', len));
+        if (!nl) return;
+        discarding = false;
+        data = nl + 1;
+    }
+
+    const char* lastNl = static_cast<const char*>(memrchr(data, '\n', (size_t)(end - data)));
+    if (lastNl) {
+        ParseStats batch;
+        if (pending.empty()) {
+            batch = LogParser::parseBuffer(data, lastNl + 1, fn);
+        } else {
+            pending.append(data, (size_t)(lastNl + 1 - data));
+            batch = LogParser::parseBuffer(pending.data(), pending.data() + pending.size(), fn);
+            pending.clear();
+        }
+        stats.parsed += batch.parsed;
+        stats.rejected += batch.rejected;
+        data = lastNl + 1;
+    }
+
+    pending.append(data, (size_t)(end - data));
+    if (pending.size() > LOG_FOLLOWER_MAX_LINE) {
+        stats.rejected++;
+        pending.clear();
+        discarding = true;
+    }
+}
+
+/*
+    readAppended
+    ------------
+    Reads everything past the offset, chunk by chunk, and parses the
+    complete lines. A trailing partial line stays in 'pending' for the
+    next batch.
+*/
+void LogFollower::readAppended(ParseStats& stats, const function<void(const ActionFields&)>& fn) {
+    if (fd < 0) return;
+
+    char chunk[READ_CHUNK];
+    while (true) {
+        ssize_t n = ::pread(fd, chunk, sizeof(chunk), offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        offset += n;
+        consume(chunk, (size_t)n, stats, fn);
+    }
+}
+
+/*
+    flushPending
+    ------------
+    The old file is finished: its last line will never get a newline, so
+    parse it as it is (as parseStream does at end of file).
+*/
+void LogFollower::flushPending(ParseStats& stats, const function<void(const ActionFields&)>& fn) {
+    discarding = false;
+    if (pending.empty()) return;
+    ParseStats batch = LogParser::parseBuffer(pending.data(), pending.data() + pending.size(), fn);
+    stats.parsed += batch.parsed;
+    stats.rejected += batch.rejected;
+    pending.clear();
+}
+
+/*
+    checkRotation
+    -------------
+    Detects a replaced file (different inode) or a truncated one (size below
+    our offset). The old file is fully drained before switching, including
+    a last line without a trailing newline.
+    Returns true if the follower switched to a new file.
+*/
+bool LogFollower::checkRotation(ParseStats& stats, const function<void(const ActionFields&)>& fn) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false; // Renamed away, new file not created yet
+
+    if (fd >= 0 && st.st_ino == inode) {
+        if (st.st_size < offset) {
+            // Truncated in place (copytruncate): start over from the beginning
+            flushPending(stats, fn);
+            offset = 0;
+            readAppended(stats, fn);
+        }
+        return false;
+    }
+
+    // Finish whatever was appended to the old file before it was rotated
+    readAppended(stats, fn);
+    flushPending(stats, fn);
+    if (!openFile(true)) return false;
+    readAppended(stats, fn);
+    return true;
+}
+
+/*
+    poll
+    ----
+    One follow step: wait for a change (or the timeout), then read the batch.
+*/
+bool LogFollower::poll(int timeoutMs, ParseStats& stats, const function<void(const ActionFields&)>& fn) {
+    if (path.empty()) return false;
+    stats = ParseStats();
+
+    if (inotifyFd >= 0) {
+        struct pollfd pfd;
+        pfd.fd = inotifyFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int rc = ::poll(&pfd, 1, timeoutMs);
+        if (rc < 0 && errno != EINTR) return false;
+        if (rc > 0) drainEvents();
+    } else {
+        usleep((useconds_t)timeoutMs * 1000);
+    }
+
+    readAppended(stats, fn);
+    if (checkRotation(stats, fn)) {
+        cout << "[Follow] Log rotated, now reading new '" << path << "'." << endl;
+    }
+    return true;
+}
@@ -0,0 +1,302 @@
+#include "log_parser.h"
+
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+    log_parser.cpp
+    --------------
+    Fast path for reading raw action logs.
+    The whole file is mapped into memory once and every line is tokenized
+    in place: text fields become string_views into the mapping and numbers
+    are converted with from_chars, so no per-line streams or temporary
+    strings are created.
+*/
+
+// Label markers of the "UserID: X, Action: Y, ..." format written by FileIO::saveAction
+static const string_view LABELS[] = {
+    "UserID: ", ", Action: ", ", Process: ", ", Duration: ",
+    ", Timestamp: ", ", NextAction: ", ", Status: "
+};
+static const int FIELD_COUNT = 7;
+
+/*
+    toUserAction
+    ------------
+    Copies the viewed fields into a regular UserAction.
+*/
+UserAction ActionFields::toUserAction() const {
+    return UserAction(string(userID), string(action), string(processName), duration,
+                      timestamp, string(nextAction), string(status));
+}
+
+/*
+    open
+    ----
+    Maps the whole file read-only.
+    An empty file is valid and simply yields a zero-length buffer.
+*/
+bool MappedFile::open(const string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if (st.st_size > 0) {
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        // We only ever walk the file front to back
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+        base = static_cast<const char*>(p);
+        length = (size_t)st.st_size;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    return true;
+}
+
+/*
+    close
+    -----
+    Releases the mapping (safe to call more than once).
+*/
+void MappedFile::close() {
+    if (base) munmap(const_cast<char*>(base), length);
+    base = nullptr;
+    length = 0;
+}
+
+// Converts a whole token to a number; trailing garbage counts as failure
+template <typename N>
+static bool toNumber(string_view token, N& out) {
+    if (token.empty()) return false;
+    const char* last = token.data() + token.size();
+    auto res = from_chars(token.data(), last, out);
+    return res.ec == errc() && res.ptr == last;
+}
+
+/*
+    parseLabelled
+    -------------
+    Handles "UserID: U101, Action: Login, ...".
+    Each value runs up to the next label marker, so values may contain spaces.
+*/
+bool LogParser::parseLabelled(string_view line, ActionFields& out) {
+    if (line.compare(0, LABELS[0].size(), LABELS[0]) != 0) return false;
+
+    string_view values[FIELD_COUNT];
+    size_t pos = LABELS[0].size();
+
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        size_t end = line.size();
+        if (i + 1 < FIELD_COUNT) {
+            end = line.find(LABELS[i + 1], pos);
+            if (end == string_view::npos) return false;
+        }
+        values[i] = line.substr(pos, end - pos);
+        if (i + 1 < FIELD_COUNT) pos = end + LABELS[i + 1].size();
+    }
+
+    if (!toNumber(values[3], out.duration)) return false;
+    if (!toNumber(values[4], out.timestamp)) return false;
+
+    out.userID = values[0];
+    out.action = values[1];
+    out.processName = values[2];
+    out.nextAction = values[5];
+    out.status = values[6];
+    return true;
+}
+
+// Splits a line into up to maxTokens space/tab separated tokens, returns the count
+static int splitTokens(string_view line, string_view* tokens, int maxTokens) {
+    int found = 0;
+    size_t i = 0;
+
+    while (found < maxTokens) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) i++;
+        if (i >= line.size()) break;
+        size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t') i++;
+        tokens[found++] = line.substr(start, i - start);
+    }
+    return found;
+}
+
+/*
+    parseWhitespace
+    ---------------
+    Handles "U101 Login explorer.exe 1.5 1700000000 Edit_Doc Normal".
+    Extra tokens after the status are ignored.
+*/
+bool LogParser::parseWhitespace(string_view line, ActionFields& out) {
+    string_view tokens[FIELD_COUNT];
+    if (splitTokens(line, tokens, FIELD_COUNT) < FIELD_COUNT) return false;
+
+    if (!toNumber(tokens[3], out.duration)) return false;
+    if (!toNumber(tokens[4], out.timestamp)) return false;
+
+    out.userID = tokens[0];
+    out.action = tokens[1];
+    out.processName = tokens[2];
+    out.nextAction = tokens[5];
+    out.status = tokens[6];
+    return true;
+}
+
+/*
+    parseTableRow
+    -------------
+    Handles the padded report rows written by FileIO::saveActionsToFile:
+    "YYYY-MM-DD HH:MM:SS  UserID  Action  Process  Duration  Next_Action  Status".
+    The date is local time, matching the localtime() used when writing.
+*/
+bool LogParser::parseTableRow(string_view line, ActionFields& out) {
+    string_view tokens[FIELD_COUNT + 1];
+    if (splitTokens(line, tokens, FIELD_COUNT + 1) < FIELD_COUNT + 1) return false;
+
+    string_view date = tokens[0], clock = tokens[1];
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return false;
+    if (clock.size() != 8 || clock[2] != ':' || clock[5] != ':') return false;
+
+    int year, mon, day, hour, min, sec;
+    if (!toNumber(date.substr(0, 4), year) || !toNumber(date.substr(5, 2), mon) ||
+        !toNumber(date.substr(8, 2), day) || !toNumber(clock.substr(0, 2), hour) ||
+        !toNumber(clock.substr(3, 2), min) || !toNumber(clock.substr(6, 2), sec)) return false;
+    if (!toNumber(tokens[5], out.duration)) return false;
+
+    struct tm t;
+    memset(&t, 0, sizeof(t));
+    t.tm_year = year - 1900;
+    t.tm_mon = mon - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    t.tm_min = min;
+    t.tm_sec = sec;
+    t.tm_isdst = -1;
+    out.timestamp = mktime(&t);
+    if (out.timestamp == (time_t)-1) return false;
+
+    out.userID = tokens[2];
+    out.action = tokens[3];
+    out.processName = tokens[4];
+    out.nextAction = tokens[6];
+    out.status = tokens[7];
+    return true;
+}
+
+/*
+    parseLine
+    ---------
+    Tries the labelled format first (what saveAction writes), then whitespace,
+    then the formatted table rows of saveActionsToFile.
+*/
+bool LogParser::parseLine(string_view line, ActionFields& out) {
+    return parseLabelled(line, out) || parseWhitespace(line, out) || parseTableRow(line, out);
+}
+
+/*
+    parseBuffer
+    -----------
+    Splits [begin, end) on '\n' (tolerating "\r\n") and parses each line.
+    Blank lines are skipped and not counted.
+*/
+ParseStats LogParser::parseBuffer(const char* begin, const char* end,
+                                  const function<void(const ActionFields&)>& fn) {
+    ParseStats stats;
+    ActionFields fields;
+    const char* p = begin;
+
+    while (p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', (size_t)(end - p)));
+        const char* lineEnd = nl ? nl : end;
+
+        string_view line(p, (size_t)(lineEnd - p));
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        if (!line.empty()) {
+            if (parseLine(line, fields)) {
+                stats.parsed++;
+                fn(fields);
+            } else {
+                stats.rejected++;
+            }
+        }
+
+        p = nl ? nl + 1 : end;
+    }
+    return stats;
+}
+
+/*
+    parseStream
+    -----------
+    Reads the file in bufferBytes pieces and parses every complete line.
+    A partial line at the end of a piece is moved to the front of the
+    buffer and finished by the next read. The buffer only grows if a
+    single line is longer than the whole window.
+*/
+bool LogParser::parseStream(const string& filename, ParseStats& stats,
+                            const function<void(const ActionFields&)>& fn,
+                            size_t bufferBytes) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    if (bufferBytes < 4096) bufferBytes = 4096;
+    string buf(bufferBytes, '\0');
+    size_t filled = 0;
+    bool ok = true;
+
+    while (true) {
+        if (filled == buf.size()) buf.resize(buf.size() * 2); // Oversized line
+
+        ssize_t n = ::read(fd, &buf[filled], buf.size() - filled);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+
+        if (n == 0) {
+            // Last line without a trailing newline
+            ParseStats tail = parseBuffer(buf.data(), buf.data() + filled, fn);
+            stats.parsed += tail.parsed;
+            stats.rejected += tail.rejected;
+            break;
+        }
+        filled += (size_t)n;
+
+        const char* start = buf.data();
+        const char* lastNl = static_cast<const char*>(memrchr(start, '\n', filled));
+        if (!lastNl) continue;
+
+        size_t used = (size_t)(lastNl - start) + 1;
+        ParseStats part = parseBuffer(start, start + used, fn);
+        stats.parsed += part.parsed;
+        stats.rejected += part.rejected;
+
+        memmove(&buf[0], start + used, filled - used);
+        filled -= used;
+    }
+
+    ::close(fd);
+    return ok;
+}
@@ -0,0 +1,36 @@
+#include "process_totals.h"
+
+using namespace std;
+
+/*
+    process_totals.cpp
+    ------------------
+    Exact per-process aggregation for batch training.
+    Names are interned once per distinct process, so a sample costs one
+    hash lookup and a few integer additions.
+*/
+
+DurationSum& ProcessTotals::at(string_view processName) {
+    SymbolID id = names.intern(processName);
+    if (id >= sums.size()) sums.resize(id + 1);
+    return sums[id];
+}
+
+/*
+    merge
+    -----
+    Integer sums add up exactly, so merge order does not matter.
+*/
+void ProcessTotals::merge(const ProcessTotals& other) {
+    for (SymbolID id = 0; id < other.sums.size(); id++) {
+        if (other.sums[id].count == 0) continue;
+        at(other.names.lookup(id)).merge(other.sums[id]);
+    }
+}
+
+void ProcessTotals::exportTo(AVLProfile& out) const {
+    for (SymbolID id = 0; id < sums.size(); id++) {
+        if (sums[id].count == 0) continue;
+        out.mergeProfile(UserActionProfile(names.lookup(id), sums[id].toStats()));
+    }
+}
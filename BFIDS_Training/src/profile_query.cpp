@@ -0,0 +1,110 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+#include "avl_profile.h"
+#include "fingerprint_file.h"
+#include "disk_btree.h"
+
+using namespace std;
+
+/*
+    profile_query.cpp
+    -----------------
+    Ordered lookups over a trained fingerprint, for investigations.
+    The fingerprint is loaded from its binary form when present (the
+    .bfp next to a CSV), otherwise from the CSV itself.
+
+        ./profile_query <fingerprint> --prefix <text>         names starting with text
+        ./profile_query <fingerprint> --range <from> <to>     names in [from, to)
+        ./profile_query <fingerprint> --from <name> [limit]   first limit names >= name
+        ./profile_query <fingerprint.csv> --lookup <name>     one name, without loading
+
+    Every mode positions one cursor in O(log n) and walks forward, so only
+    the matching entries are touched. --lookup does not load the profile
+    at all: it reads the name's row offset from the paged index written
+    next to the CSV (x_index.bin) and then that single row.
+*/
+
+static bool loadFingerprint(const string& path, AVLProfile& profile) {
+    const string ext = ".bfp";
+    if (path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0) {
+        return profile.importFromBinary(path);
+    }
+    return profile.importFromBinary(FingerprintFile::pathFor(path)) || profile.importFromCSV(path);
+}
+
+static void printRow(string_view name, const DurationStats& s) {
+    cout << left << setw(32) << name << right
+         << setw(10) << s.frequency
+         << setw(12) << s.avgDuration
+         << setw(12) << s.stddev()
+         << setw(12) << s.minDuration
+         << setw(12) << s.maxDuration << "\n";
+}
+
+static void printUsage(const char* program) {
+    cerr << "Usage: " << program << " <fingerprint> --prefix <text>\n"
+         << "       " << program << " <fingerprint> --range <from> <to>\n"
+         << "       " << program << " <fingerprint> --from <name> [limit]\n"
+         << "       " << program << " <fingerprint.csv> --lookup <name>\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4 || (string(argv[2]) == "--range" && argc < 5)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (string(argv[2]) == "--lookup") {
+        auto start = chrono::steady_clock::now();
+        UserActionProfile p;
+        PageCacheStats io;
+        bool scanned = false;
+        bool found = AVLProfile::findInCSV(argv[1], argv[3], p, &io, &scanned);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        cout << fixed << setprecision(3);
+        if (found) printRow(p.processName, p);
+        else cout << "'" << argv[3] << "' is not in the fingerprint.\n";
+        if (!scanned) cout << "Index pages read: " << io.reads << " (" << ms << " ms).\n";
+        else if (io.reads > 0) cout << "Index pages read: " << io.reads << ", then scanned the CSV (" << ms << " ms).\n";
+        else cout << "No current index for '" << argv[1] << "'; scanned the CSV (" << ms << " ms).\n";
+        return found ? 0 : 2;
+    }
+
+    AVLProfile profile;
+    if (!loadFingerprint(argv[1], profile)) {
+        cerr << "Error: Could not load fingerprint '" << argv[1] << "'.\n";
+        return 1;
+    }
+
+    string mode = argv[2];
+    cout << fixed << setprecision(3)
+         << left << setw(32) << "ProcessName" << right
+         << setw(10) << "Frequency" << setw(12) << "AvgDuration" << setw(12) << "StdDev"
+         << setw(12) << "Min" << setw(12) << "Max" << "\n";
+
+    auto start = chrono::steady_clock::now();
+    size_t count = 0;
+    if (mode == "--prefix") {
+        count = profile.scanPrefix(argv[3], printRow);
+    } else if (mode == "--range") {
+        count = profile.scanRange(argv[3], argv[4], printRow);
+    } else if (mode == "--from") {
+        size_t limit = (argc >= 5) ? (size_t)atoll(argv[4]) : 20;
+        for (AVLProfile::Cursor c = profile.lowerBound(argv[3]); c.valid() && count < limit; c.next()) {
+            printRow(c.key(), c.stats());
+            count++;
+        }
+    } else {
+        cerr << "Error: Unknown mode '" << mode << "'.\n";
+        return 1;
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << count << " of " << profile.size() << " processes matched (" << ms << " ms).\n";
+    return 0;
+}
@@ -0,0 +1,375 @@
+#include "segmented_log.h"
+#include "file_io.h"
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <sys/stat.h>
+#include <dirent.h>
+
+using namespace std;
+
+/*
+    segmented_log.cpp
+    -----------------
+    Time-partitioned storage for action logs.
+    Instead of one ever-growing file, events go into a sequence of segments.
+    The manifest records the time range of every segment and each segment
+    has a sparse index of (offset, min/max timestamp) per stride of records,
+    so a time-window query skips whole segments and, inside a segment,
+    parses only the strides that can match.
+*/
+
+static const char SEGMENT_INDEX_MAGIC[4] = { 'B', 'F', 'S', 'X' };
+static const char* MANIFEST_FILE = "MANIFEST";
+static const size_t SEGMENT_WRITE_BUFFER = 1 << 20;
+
+static string joinPath(const string& dir, const string& file) {
+    if (dir.empty() || dir.back() == '/') return dir + file;
+    return dir + "/" + file;
+}
+
+/*
+    readManifest
+    ------------
+    Parses "<name> <minTs> <maxTs> <records> <bytes>" lines ('#' starts a comment).
+    A missing manifest is reported as false; malformed lines are skipped.
+*/
+static bool readManifest(const string& dir, vector<SegmentInfo>& manifest) {
+    manifest.clear();
+    ifstream in(joinPath(dir, MANIFEST_FILE));
+    if (!in.is_open()) return false;
+
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        istringstream fields(line);
+        SegmentInfo seg;
+        long long minTs, maxTs;
+        if (fields >> seg.name >> minTs >> maxTs >> seg.records >> seg.bytes) {
+            seg.minTs = (time_t)minTs;
+            seg.maxTs = (time_t)maxTs;
+            manifest.push_back(seg);
+        }
+    }
+    return true;
+}
+
+/*
+    scanSegmentFiles
+    ----------------
+    Lists the segment names ("seg_<ts>_<seq>") that have a file in the
+    directory and returns one past the highest sequence number found.
+*/
+static int scanSegmentFiles(const string& dir, vector<string>& names) {
+    names.clear();
+    int next = 0;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return next;
+
+    while (dirent* entry = readdir(d)) {
+        string file = entry->d_name;
+        if (file.compare(0, 4, "seg_") != 0) continue;
+        size_t dot = file.rfind('.');
+        size_t sep = file.rfind('_', dot);
+        if (dot == string::npos || sep == string::npos || sep < 4) continue;
+
+        string name = file.substr(0, dot);
+        if (find(names.begin(), names.end(), name) == names.end()) names.push_back(name);
+        int seq = atoi(file.c_str() + sep + 1);
+        if (seq >= next) next = seq + 1;
+    }
+    closedir(d);
+    return next;
+}
+
+// ======================= WRITER =======================
+
+SegmentedLogWriter::SegmentedLogWriter(time_t spanSeconds, size_t segmentBytes)
+    : maxSpan(spanSeconds > 0 ? spanSeconds : SEGMENT_DEFAULT_SPAN),
+      maxBytes(segmentBytes ? segmentBytes : SEGMENT_DEFAULT_BYTES),
+      segmentStart(0),
+      sequence(0) {}
+
+SegmentedLogWriter::~SegmentedLogWriter() {
+    close();
+}
+
+/*
+    open
+    ----
+    Creates the directory if needed and loads its manifest.
+    The segment itself is only created by the first append.
+    Segment files missing from the manifest (a writer that crashed or
+    failed before sealing) are left alone and reported; new segments
+    are numbered past every existing file, so they are never reused.
+*/
+bool SegmentedLogWriter::open(const string& directory) {
+    close();
+    dir = directory;
+
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        cerr << "Error: Could not create segment directory '" << dir << "'.\n";
+        return false;
+    }
+
+    readManifest(dir, manifest);
+
+    vector<string> names;
+    sequence = max((int)manifest.size(), scanSegmentFiles(dir, names));
+    for (const string& name : names) {
+        bool listed = false;
+        for (const SegmentInfo& seg : manifest) {
+            if (seg.name == name) { listed = true; break; }
+        }
+        if (!listed) cerr << "Warning: Skipping unsealed segment '" << name << "' (not in the manifest).\n";
+    }
+    return true;
+}
+
+/*
+    startSegment
+    ------------
+    Opens a fresh segment file named after its first timestamp and sequence number.
+*/
+bool SegmentedLogWriter::startSegment(time_t firstTs) {
+    current = SegmentInfo();
+    current.name = "seg_" + to_string((long long)firstTs) + "_" + to_string(sequence++);
+    current.minTs = current.maxTs = firstTs;
+    segmentStart = firstTs;
+    index.clear();
+    buffer.clear();
+
+    out.open(joinPath(dir, current.name + ".log"), ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Error: Could not create segment '" << current.name << "'.\n";
+        return false;
+    }
+    return true;
+}
+
+bool SegmentedLogWriter::writeBuffer() {
+    if (buffer.empty()) return true;
+    out.write(buffer.data(), (streamsize)buffer.size());
+    buffer.clear();
+    return (bool)out;
+}
+
+/*
+    append
+    ------
+    Rolls first if the event falls outside the segment's time span or the
+    segment is full, then formats the line and updates the sparse index.
+*/
+bool SegmentedLogWriter::append(const UserAction& action) {
+    if (dir.empty()) return false;
+
+    if (out.is_open() &&
+        (action.timestamp - segmentStart >= maxSpan || current.bytes >= maxBytes)) {
+        if (!sealSegment()) return false;
+    }
+    if (!out.is_open() && !startSegment(action.timestamp)) return false;
+
+    int64_t ts = (int64_t)action.timestamp;
+    if (current.records % SEGMENT_INDEX_STRIDE == 0) {
+        index.push_back({ current.bytes, ts, ts });
+    } else {
+        SegmentIndexEntry& e = index.back();
+        if (ts < e.minTs) e.minTs = ts;
+        if (ts > e.maxTs) e.maxTs = ts;
+    }
+    if (action.timestamp < current.minTs) current.minTs = action.timestamp;
+    if (action.timestamp > current.maxTs) current.maxTs = action.timestamp;
+
+    size_t before = buffer.size();
+    FileIO::appendActionLine(action, buffer);
+    current.bytes += buffer.size() - before;
+    current.records++;
+
+    if (buffer.size() >= SEGMENT_WRITE_BUFFER) return writeBuffer();
+    return true;
+}
+
+/*
+    sealSegment
+    -----------
+    Finishes the active segment: writes its data and index, then publishes
+    it in the manifest. Until then, queries do not see the segment.
+    A segment whose data or index could not be written is never published;
+    its files stay behind as an unsealed segment.
+*/
+bool SegmentedLogWriter::sealSegment() {
+    if (!out.is_open()) return true;
+
+    bool ok = writeBuffer();
+    out.close();
+
+    ofstream idx(joinPath(dir, current.name + ".idx"), ios::binary | ios::trunc);
+    idx.write(SEGMENT_INDEX_MAGIC, sizeof(SEGMENT_INDEX_MAGIC));
+    idx.write(reinterpret_cast<const char*>(&SEGMENT_INDEX_VERSION), sizeof(SEGMENT_INDEX_VERSION));
+    if (!index.empty()) {
+        idx.write(reinterpret_cast<const char*>(index.data()),
+                  (streamsize)(index.size() * sizeof(SegmentIndexEntry)));
+    }
+    ok = (bool)idx && ok;
+    idx.close();
+
+    index.clear();
+    if (ok) {
+        manifest.push_back(current);
+        ok = writeManifest();
+        if (!ok) manifest.pop_back();
+    }
+
+    if (!ok) cerr << "Error: Failed to seal segment '" << current.name << "'.\n";
+    return ok;
+}
+
+/*
+    writeManifest
+    -------------
+    Rewrites the manifest through a temporary file and rename(), so readers
+    always see either the old or the new list, never a half-written one.
+*/
+bool SegmentedLogWriter::writeManifest() const {
+    string path = joinPath(dir, MANIFEST_FILE);
+    string tmp = path + ".tmp";
+
+    ofstream m(tmp, ios::trunc);
+    if (!m.is_open()) return false;
+    m << "# name minTs maxTs records bytes\n";
+    for (const SegmentInfo& seg : manifest) {
+        m << seg.name << ' ' << (long long)seg.minTs << ' ' << (long long)seg.maxTs << ' '
+          << seg.records << ' ' << seg.bytes << '\n';
+    }
+    m.close();
+    if (!m) return false;
+
+    return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool SegmentedLogWriter::close() {
+    bool ok = sealSegment();
+    dir.clear();
+    manifest.clear();
+    return ok;
+}
+
+// ======================= READER =======================
+
+bool SegmentedLogReader::open(const string& directory) {
+    dir = directory;
+    if (!readManifest(dir, manifest)) {
+        cerr << "Error: No segment manifest in '" << dir << "'.\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+    loadIndex
+    ---------
+    Reads a segment's sparse index. False if it is missing or damaged,
+    in which case the caller scans the whole segment.
+*/
+bool SegmentedLogReader::loadIndex(const SegmentInfo& seg, vector<SegmentIndexEntry>& index) const {
+    index.clear();
+    ifstream in(joinPath(dir, seg.name + ".idx"), ios::binary | ios::ate);
+    if (!in.is_open()) return false;
+
+    streamoff size = in.tellg();
+    size_t header = sizeof(SEGMENT_INDEX_MAGIC) + sizeof(uint32_t);
+    if (size < (streamoff)header || (size - header) % sizeof(SegmentIndexEntry) != 0) return false;
+    in.seekg(0);
+
+    char magic[4];
+    uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || !in.read(reinterpret_cast<char*>(&version), sizeof(version)))
+        return false;
+    if (memcmp(magic, SEGMENT_INDEX_MAGIC, sizeof(magic)) != 0 || version != SEGMENT_INDEX_VERSION)
+        return false;
+
+    index.resize((size_t)(size - header) / sizeof(SegmentIndexEntry));
+    return index.empty() ||
+           (bool)in.read(reinterpret_cast<char*>(index.data()), index.size() * sizeof(SegmentIndexEntry));
+}
+
+/*
+    query
+    -----
+    1. Manifest: skip segments whose [minTs, maxTs] misses [t1, t2).
+    2. Sparse index: inside a segment, keep only strides whose bounds overlap,
+       merging neighbours into contiguous byte ranges.
+    3. Parse just those ranges of the mapped segment and filter exactly.
+*/
+bool SegmentedLogReader::query(time_t t1, time_t t2, const function<void(const ActionFields&)>& fn,
+                               SegmentQueryStats* stats) const {
+    SegmentQueryStats local;
+    local.segmentsTotal = manifest.size();
+    bool ok = true;
+
+    auto emit = [&](const ActionFields& f) {
+        if (f.timestamp >= t1 && f.timestamp < t2) {
+            local.matched++;
+            fn(f);
+        }
+    };
+
+    vector<SegmentIndexEntry> index;
+    for (const SegmentInfo& seg : manifest) {
+        if (!seg.overlaps(t1, t2)) continue;
+
+        MappedFile file;
+        if (!file.open(joinPath(dir, seg.name + ".log"))) {
+            cerr << "Error: Segment '" << seg.name << "' is listed but cannot be opened.\n";
+            ok = false;
+            continue;
+        }
+        local.segmentsRead++;
+
+        const char* base = file.data();
+        size_t end = file.size();
+
+        if (!loadIndex(seg, index)) {
+            LogParser::parseBuffer(base, base + end, emit);
+            local.bytesRead += end;
+            continue;
+        }
+
+        size_t i = 0;
+        while (i < index.size()) {
+            if (index[i].maxTs < (int64_t)t1 || index[i].minTs >= (int64_t)t2) {
+                i++;
+                continue;
+            }
+            size_t from = (size_t)index[i].offset;
+            while (i + 1 < index.size() &&
+                   index[i + 1].maxTs >= (int64_t)t1 && index[i + 1].minTs < (int64_t)t2) {
+                i++;
+            }
+            size_t to = (i + 1 < index.size()) ? (size_t)index[i + 1].offset : end;
+            if (from < to && to <= end) {
+                LogParser::parseBuffer(base + from, base + to, emit);
+                local.bytesRead += to - from;
+            }
+            i++;
+        }
+    }
+
+    if (stats) *stats = local;
+    return ok;
+}
+
+size_t SegmentedLogReader::query(time_t t1, time_t t2, LinkedList& list, SegmentQueryStats* stats) const {
+    size_t added = 0;
+    query(t1, t2, [&](const ActionFields& f) {
+        list.insertAtEnd(f.toUserAction());
+        added++;
+    }, stats);
+    return added;
+}
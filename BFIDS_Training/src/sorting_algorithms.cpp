@@ -1,5 +1,7 @@
 #include "sorting_algorithms.h"
 #include <iostream>
+#include <vector>
+#include <cstring>
 
 using namespace std;
 
@@ -190,4 +192,62 @@ void SortingAlgorithms::heapSort(UserAction arr[], size_t n) {
         // Call max heapify on the reduced heap
         heapify(arr, i, 0);
     }
-}
\ No newline at end of file
+}
+
+/*
+    radixArgsort
+    ------------
+    LSD Radix Sort over a timestamp column, producing a permutation.
+    Keys are shifted by the minimum so only the bytes that actually vary
+    are processed (a few months of timestamps need 3-4 passes).
+    Each pass is a stable counting sort on one byte that moves (key, index)
+    pairs sequentially, so the cost is a handful of linear memory sweeps.
+    Time Complexity: O(n * passes).
+*/
+void SortingAlgorithms::radixArgsort(const time_t keys[], uint32_t perm[], size_t n) {
+    if (n == 0) return;
+
+    time_t minKey = keys[0], maxKey = keys[0];
+    for (size_t i = 1; i < n; i++) {
+        if (keys[i] < minKey) minKey = keys[i];
+        if (keys[i] > maxKey) maxKey = keys[i];
+    }
+
+    uint64_t range = (uint64_t)maxKey - (uint64_t)minKey;
+    int passes = 0;
+    while (range > 0) {
+        passes++;
+        range >>= 8;
+    }
+
+    for (size_t i = 0; i < n; i++) perm[i] = (uint32_t)i;
+    if (passes == 0) return; // All keys equal
+
+    vector<uint64_t> key(n), keyTmp(n);
+    vector<uint32_t> permTmp(n);
+    for (size_t i = 0; i < n; i++) key[i] = (uint64_t)keys[i] - (uint64_t)minKey;
+
+    uint32_t* src = perm;
+    uint32_t* dst = permTmp.data();
+    uint64_t* ksrc = key.data();
+    uint64_t* kdst = keyTmp.data();
+
+    for (int p = 0; p < passes; p++) {
+        int shift = p * 8;
+        size_t count[257];
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; i++) count[((ksrc[i] >> shift) & 0xFF) + 1]++;
+        for (int b = 0; b < 256; b++) count[b + 1] += count[b];
+
+        for (size_t i = 0; i < n; i++) {
+            size_t pos = count[(ksrc[i] >> shift) & 0xFF]++;
+            dst[pos] = src[i];
+            kdst[pos] = ksrc[i];
+        }
+        swap(src, dst);
+        swap(ksrc, kdst);
+    }
+
+    // After an odd number of passes the result sits in the scratch buffer
+    if (src != perm) memcpy(perm, src, n * sizeof(uint32_t));
+}
@@ -1,11 +1,17 @@
 #include "linked_list.h"
 #include "file_io.h"
+#include "event_log.h"
 
 #include "sorting_algorithms.h"
 #include "avl_profile.h"
+#include "parallel_ingest.h"
+#include "process_totals.h"
+#include "event_table.h"
+#include "fingerprint_file.h"
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <cstdlib> // Added for system()
 
 using namespace std;
@@ -15,78 +21,251 @@ using namespace std;
     ----------------
     Batch Training Module.
     Processes raw log files to create a behavioral fingerprint.
-    
-    Process Flow:
-    1. ETL (Extract): Load raw actions from a log file into a Linked List.
-    2. Sort: Convert List to Array and Sort by Timestamp (Merge Sort).
-    3. Train: Insert sorted actions into an AVL Tree to calculate averages/frequencies.
-    4. Export: Save the final fingerprint to CSV.
-*/
 
-int main(int argc, char* argv[]) {
+    Process Flow (default, streaming):
+    1. Stream: Parse the log through a fixed-size buffer (text) or block by
+       block (binary event logs, see event_log.h).
+    2. Train: Feed every action straight into exact per-process sums
+       (process_totals.h), then build the AVL Tree of averages/frequencies.
+       Memory grows only with the number of distinct processes, never
+       with the log size.
+    3. Export: Save the final fingerprint to CSV.
 
-    string rawLog = "raw_actions.log";
-    // --- CHANGE: Default path updated ---
-    string outCsv = "fingerprints/fingerprints.csv";
+    Report mode (--report FILE) keeps the materializing pipeline:
+    Load into a column store (event_table.h) -> Aggregate per process ->
+    Radix argsort by timestamp, and additionally writes the time-ordered
+    action table to FILE.
 
-    // Allow custom input and output file names
-    if (argc >= 2) rawLog = argv[1];
-    if (argc >= 3) outCsv = argv[2];
+    Usage: ./train_system [--threads N] [--report FILE] [raw_log] [out_csv]
+           ./train_system --check-threads [N] [raw_log]
+    With --threads, text logs are split into N line-aligned chunks that are
+    parsed and aggregated in parallel (see parallel_ingest.h). Every path
+    sums durations exactly, so the CSV and .bfp are byte-identical whatever
+    the mode or thread count. --check-threads trains the log sequentially
+    and with 1, 4 and N (default 7) threads and compares the .bfp images.
+*/
 
-    cout << "\nTraining started...\n";
+/*
+    trainStreaming
+    --------------
+    Single pass: parse and aggregate without keeping any action around.
+*/
+bool trainStreaming(const string& rawLog, AVLProfile& fingerprint) {
+    ProcessTotals totals;
+    ParseStats stats;
+    bool ok;
 
-    // Loading the raw actions into our linked list
-    LinkedList list;
-    bool ok = FileIO::loadActionsFromFile(rawLog, list);
+    if (EventLogReader::isEventLog(rawLog)) {
+        EventLogReader reader;
+        ok = reader.open(rawLog);
+        UserAction ua;
+        while (ok && reader.next(ua)) {
+            totals.add(ua.processName, ua.duration);
+            stats.parsed++;
+        }
+    } else {
+        ok = LogParser::parseStream(rawLog, stats, [&](const ActionFields& f) {
+            totals.add(f.processName, f.duration);
+        });
+    }
 
-    if (!ok || list.getSize() == 0) {
+    if (!ok || stats.parsed == 0) {
         cerr << "Could not load raw logs. Nothing to train.\n";
-        return 1;
+        return false;
     }
+    totals.exportTo(fingerprint);
+
+    cout << "Streamed " << stats.parsed << " actions ("
+         << stats.rejected << " malformed lines rejected).\n";
+    return true;
+}
 
-    cout << "Loaded " << list.getSize() << " actions.\n";
+/*
+    trainSorted
+    -----------
+    The materializing pipeline. Only used when a time-ordered report is
+    requested (reportFile), since the aggregates themselves do not depend
+    on event order. Events are kept column by column (event_table.h), so
+    the aggregation scans only process ids and durations and the sort only
+    touches the timestamp column.
+*/
+bool trainSorted(const string& rawLog, const string& reportFile, AVLProfile& fingerprint) {
+    // Loading the raw actions into the column store
+    EventTable events;
+    ParseStats stats;
+    bool ok;
+    if (EventLogReader::isEventLog(rawLog)) {
+        EventLogReader reader;
+        ok = reader.open(rawLog);
+        UserAction ua;
+        while (ok && reader.next(ua)) events.append(ua);
+    } else {
+        ok = LogParser::parseStream(rawLog, stats, [&](const ActionFields& f) {
+            events.append(f);
+        });
+    }
 
-    // Converting list into a plain array for sorting
-    int count = 0;
-    UserAction* arr = new UserAction[count];
-     list.copyToArray(arr);
+    if (!ok || events.empty()) {
+        cerr << "Could not load raw logs. Nothing to train.\n";
+        return false;
+    }
 
+    size_t count = events.size();
+    cout << "Loaded " << count << " actions ("
+         << stats.rejected << " malformed lines rejected), "
+         << events.symbolTable().size() << " distinct strings, ~"
+         << events.memoryUsage() / count << " bytes/event.\n";
 
-    if (!arr || count == 0) {
-        cerr << "Failed to convert list to array.\n";
-        return 1;
+    // Building the fingerprint using an AVL tree
+    // One scan of (process, duration) gives the exact sums per process,
+    // then each process is merged into the tree once
+    vector<DurationSum> perProcess;
+    events.aggregateByProcess(perProcess);
+    const SymbolTable& symbols = events.symbolTable();
+    for (SymbolID id = 0; id < perProcess.size(); id++) {
+        if (perProcess[id].count == 0) continue;
+        fingerprint.mergeProfile(UserActionProfile(symbols.lookup(id), perProcess[id].toStats()));
     }
 
-    // Sorting everything by timestamp
-    // Uses Merge Sort O(n log n)
-    SortingAlgorithms::mergeSort(arr, 0, count - 1);
+    // Sorting by timestamp
+    // Radix argsort O(n) over the timestamp column; rows stay in place
+    vector<uint32_t> order = events.sortedByTimestamp();
     cout << "Actions sorted.\n";
 
-    // Building the fingerprint using an AVL tree
-    // Aggregates frequency and calculates running average duration
+    // Time-ordered report through the permutation
+    bool reported = FileIO::writeActionTable(events, order, reportFile);
+    if (reported) cout << "Time-ordered report written to " << reportFile << endl;
+
+    return reported;
+}
+
+/*
+    trainParallel
+    -------------
+    Chunked multi-threaded aggregation of a text log.
+*/
+bool trainParallel(const string& rawLog, int threads, AVLProfile& fingerprint) {
+    ParseStats stats;
+    if (!ParallelIngest::buildProfile(rawLog, threads, fingerprint, stats) || stats.parsed == 0) {
+        cerr << "Could not load raw logs. Nothing to train.\n";
+        return false;
+    }
+
+    cout << "Loaded " << stats.parsed << " actions ("
+         << stats.rejected << " malformed lines rejected) using "
+         << threads << " thread(s).\n";
+    return true;
+}
+
+/*
+    checkThreads
+    ------------
+    Trains rawLog on the sequential path and with 1, 4 and n threads and
+    compares the binary fingerprint images byte for byte.
+    Returns 0 if all of them are identical.
+*/
+int checkThreads(const string& rawLog, int n) {
+    AVLProfile sequential;
+    if (!trainStreaming(rawLog, sequential)) return 1;
+    string expected;
+    sequential.encodeBinary(expected);
+
+    int failures = 0;
+    for (int threads : { 1, 4, n }) {
+        AVLProfile parallel;
+        if (!trainParallel(rawLog, threads, parallel)) return 1;
+        string image;
+        parallel.encodeBinary(image);
+
+        size_t diff = 0;
+        for (size_t i = 0; i < image.size() && i < expected.size(); i++) {
+            if (image[i] != expected[i]) diff++;
+        }
+        bool same = image.size() == expected.size() && diff == 0;
+        cout << "--threads " << threads << ": " << image.size() << " bytes, "
+             << (same ? "identical to the sequential .bfp" : "DIFFERS");
+        if (!same) cout << " (" << diff << " bytes differ, sizes " << image.size() << "/" << expected.size() << ")";
+        cout << "\n";
+        if (!same) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+
+    string rawLog = "raw_actions.log";
+    // --- CHANGE: Default path updated ---
+    string outCsv = "fingerprints/fingerprints.csv";
+    string reportFile;   // Empty = no time-ordered report (streaming mode)
+    int threads = 0;     // 0 = single-threaded
+    bool checkMode = false;
+
+    // Allow custom input and output file names (plus options anywhere)
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 1) {
+                cerr << "--threads expects a positive number.\n";
+                return 1;
+            }
+        } else if (arg == "--check-threads") {
+            checkMode = true;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) threads = atoi(argv[++i]);
+        } else if (arg == "--report" && i + 1 < argc) {
+            reportFile = argv[++i];
+        } else if (positional == 0) {
+            rawLog = arg;
+            positional++;
+        } else if (positional == 1) {
+            outCsv = arg;
+            positional++;
+        }
+    }
+
+    if (checkMode) return checkThreads(rawLog, threads > 0 ? threads : 7);
+
+    cout << "\nTraining started...\n";
+
     AVLProfile fingerprint;
-    for (int i = 0; i < count; i++) {
-        fingerprint.insertOrUpdate(arr[i].processName, arr[i].duration);
+    bool trained;
+    if (!reportFile.empty()) {
+        if (threads > 0) cout << "Report mode is sequential; ignoring --threads.\n";
+        trained = trainSorted(rawLog, reportFile, fingerprint);
+    } else if (threads > 0 && EventLogReader::isEventLog(rawLog)) {
+        cout << "Binary event logs are read sequentially; ignoring --threads.\n";
+        trained = trainStreaming(rawLog, fingerprint);
+    } else if (threads > 0) {
+        trained = trainParallel(rawLog, threads, fingerprint);
+    } else {
+        trained = trainStreaming(rawLog, fingerprint);
     }
 
+    if (!trained) return 1;
+
     cout << "Fingerprint tree created.\n";
 
     // --- CHANGE: Ensure directory exists ---
     system("mkdir -p fingerprints");
 
-    // Saving the fingerprint to a CSV file
+    // Saving the fingerprint to a CSV file, plus the binary copy the monitors load
     bool saved = fingerprint.exportToCSV(outCsv);
 
     if (!saved) {
         cerr << "Could not save fingerprint CSV.\n";
-        delete[] arr;
         return 1;
     }
 
     cout << "Fingerprint saved to " << outCsv << endl;
 
-    delete[] arr;
+    string outBinary = FingerprintFile::pathFor(outCsv);
+    if (!fingerprint.exportToBinary(outBinary)) {
+        cerr << "Could not save binary fingerprint.\n";
+        return 1;
+    }
+    cout << "Binary fingerprint saved to " << outBinary << endl;
 
     cout << "Training finished.\n";
     return 0;
-}
\ No newline at end of file
+}